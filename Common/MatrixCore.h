@@ -0,0 +1,408 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <limits>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__) || defined(__AVX__)
+#include <smmintrin.h>
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#endif
+
+// Matrix core shared by the calculators.
+// Kernels work on views, so they run unchanged over the calculators' nested vector<vector<T>>
+// matrices and over contiguous DenseMatrix storage and its blocks. Inner loops are unit-stride over
+// rows so compilers vectorize them for int, long long, float and double.
+// Callers check dimensions before calling a kernel, each with their own error handling.
+namespace MatrixCore {
+
+    // Type used to sum products of T before they are stored back
+    template <typename T>
+    struct AccumulatorFor {
+        typedef T type;
+    };
+
+    template <>
+    struct AccumulatorFor<int> {
+        typedef long long type;
+    };
+
+    // Row-major matrix stored in one contiguous block
+    template <typename T>
+    struct DenseMatrix {
+        int rows = 0;
+        int cols = 0;
+        std::vector<T> data;
+
+        DenseMatrix() {}
+
+        DenseMatrix(int r, int c, T value = T())
+            : rows(r), cols(c), data(static_cast<size_t>(r) * c, value) {}
+
+        T* row(int i) {
+            return data.data() + static_cast<size_t>(i) * cols;
+        }
+
+        const T* row(int i) const {
+            return data.data() + static_cast<size_t>(i) * cols;
+        }
+
+        T& operator()(int i, int j) {
+            return row(i)[j];
+        }
+
+        const T& operator()(int i, int j) const {
+            return row(i)[j];
+        }
+    };
+
+    // View of a rows x cols region of contiguous row-major storage with the given row stride
+    template <typename T>
+    struct MatrixView {
+        T* data;
+        int rows;
+        int cols;
+        size_t stride;
+
+        T* row(int i) const {
+            return data + static_cast<size_t>(i) * stride;
+        }
+    };
+
+    // View of a vector<vector<T>> matrix; T may be const for a read-only view
+    template <typename Nested>
+    struct NestedMatrixView {
+        Nested& matrix;
+        int rows;
+        int cols;
+
+        auto row(int i) const -> decltype(matrix[i].data()) {
+            return matrix[i].data();
+        }
+    };
+
+    template <typename T>
+    MatrixView<T> view(DenseMatrix<T>& matrix) {
+        return MatrixView<T>{ matrix.data.data(), matrix.rows, matrix.cols, static_cast<size_t>(matrix.cols) };
+    }
+
+    template <typename T>
+    MatrixView<const T> view(const DenseMatrix<T>& matrix) {
+        return MatrixView<const T>{ matrix.data.data(), matrix.rows, matrix.cols, static_cast<size_t>(matrix.cols) };
+    }
+
+    template <typename T>
+    NestedMatrixView<std::vector<std::vector<T>>> view(std::vector<std::vector<T>>& matrix) {
+        return NestedMatrixView<std::vector<std::vector<T>>>{ matrix, static_cast<int>(matrix.size()),
+            matrix.empty() ? 0 : static_cast<int>(matrix[0].size()) };
+    }
+
+    template <typename T>
+    NestedMatrixView<const std::vector<std::vector<T>>> view(const std::vector<std::vector<T>>& matrix) {
+        return NestedMatrixView<const std::vector<std::vector<T>>>{ matrix, static_cast<int>(matrix.size()),
+            matrix.empty() ? 0 : static_cast<int>(matrix[0].size()) };
+    }
+
+    // View of the rows x cols block of a contiguous view starting at (row, col)
+    template <typename T>
+    MatrixView<T> block(const MatrixView<T>& source, int row, int col, int rows, int cols) {
+        return MatrixView<T>{ source.row(row) + col, rows, cols, source.stride };
+    }
+
+    // Contiguous copy of a nested matrix
+    template <typename T>
+    DenseMatrix<T> toDense(const std::vector<std::vector<T>>& matrix) {
+        DenseMatrix<T> dense(static_cast<int>(matrix.size()), matrix.empty() ? 0 : static_cast<int>(matrix[0].size()));
+        for (int i = 0; i < dense.rows; i++) {
+            std::copy(matrix[i].begin(), matrix[i].begin() + dense.cols, dense.row(i));
+        }
+        return dense;
+    }
+
+    // Nested copy of a contiguous matrix
+    template <typename T>
+    std::vector<std::vector<T>> toNested(const DenseMatrix<T>& matrix) {
+        std::vector<std::vector<T>> nested(matrix.rows);
+        for (int i = 0; i < matrix.rows; i++) {
+            nested[i].assign(matrix.row(i), matrix.row(i) + matrix.cols);
+        }
+        return nested;
+    }
+
+    // row[j] *= scalar for j in [0, count)
+    template <typename T>
+    inline void scaleRow(T* row, size_t count, T scalar) {
+        for (size_t j = 0; j < count; j++) {
+            row[j] *= scalar;
+        }
+    }
+
+    // destination[j] += scalar * source[j] for j in [0, count)
+    template <typename T>
+    inline void addScaledRow(T* destination, const T* source, size_t count, T scalar) {
+        for (size_t j = 0; j < count; j++) {
+            destination[j] += scalar * source[j];
+        }
+    }
+
+    // output = left + right, elementwise
+    template <typename Output, typename Left, typename Right>
+    void addInto(const Left& left, const Right& right, const Output& output) {
+        for (int i = 0; i < left.rows; i++) {
+            auto a = left.row(i);
+            auto b = right.row(i);
+            auto out = output.row(i);
+
+            for (int j = 0; j < left.cols; j++) {
+                out[j] = a[j] + b[j];
+            }
+        }
+    }
+
+    // output = left - right, elementwise
+    template <typename Output, typename Left, typename Right>
+    void subtractInto(const Left& left, const Right& right, const Output& output) {
+        for (int i = 0; i < left.rows; i++) {
+            auto a = left.row(i);
+            auto b = right.row(i);
+            auto out = output.row(i);
+
+            for (int j = 0; j < left.cols; j++) {
+                out[j] = a[j] - b[j];
+            }
+        }
+    }
+
+    // output = source * scalar, elementwise
+    template <typename Output, typename Source, typename T>
+    void scaleInto(const Source& source, T scalar, const Output& output) {
+        for (int i = 0; i < source.rows; i++) {
+            auto a = source.row(i);
+            auto out = output.row(i);
+
+            for (int j = 0; j < source.cols; j++) {
+                out[j] = a[j] * scalar;
+            }
+        }
+    }
+
+    // Fully unrolled N x N product of row-major a and b, summed in Accumulator.
+    // The loop bounds are compile-time constants, so the compiler unrolls them completely and
+    // keeps each output row in registers (broadcast a[i][k], multiply by row k of b, add).
+    template <int N, typename Accumulator, typename T>
+    inline void multiplySmall(const T* a, const T* b, Accumulator* out) {
+        for (int i = 0; i < N; i++) {
+            Accumulator row[N] = {};
+
+            for (int k = 0; k < N; k++) {
+                Accumulator factor = a[i * N + k];
+                for (int j = 0; j < N; j++) {
+                    row[j] += factor * static_cast<Accumulator>(b[k * N + j]);
+                }
+            }
+
+            for (int j = 0; j < N; j++) {
+                out[i * N + j] = row[j];
+            }
+        }
+    }
+
+#if defined(__AVX2__)
+    // 4x4 int product with 64-bit sums: one output row per 256-bit register of four int64 lanes
+    template <>
+    inline void multiplySmall<4, long long, int>(const int* a, const int* b, long long* out) {
+        __m256i b0 = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+        __m256i b1 = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 4)));
+        __m256i b2 = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 8)));
+        __m256i b3 = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 12)));
+
+        for (int i = 0; i < 4; i++) {
+            const int* r = a + i * 4;
+            __m256i row = _mm256_mul_epi32(_mm256_set1_epi64x(r[0]), b0);
+            row = _mm256_add_epi64(row, _mm256_mul_epi32(_mm256_set1_epi64x(r[1]), b1));
+            row = _mm256_add_epi64(row, _mm256_mul_epi32(_mm256_set1_epi64x(r[2]), b2));
+            row = _mm256_add_epi64(row, _mm256_mul_epi32(_mm256_set1_epi64x(r[3]), b3));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 4), row);
+        }
+    }
+#elif defined(__SSE4_1__) || defined(__AVX__)
+    // 4x4 int product with 64-bit sums: each output row is two 128-bit registers of two int64 lanes
+    template <>
+    inline void multiplySmall<4, long long, int>(const int* a, const int* b, long long* out) {
+        __m128i low[4];
+        __m128i high[4];
+
+        for (int k = 0; k < 4; k++) {
+            __m128i row = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + k * 4));
+            low[k] = _mm_cvtepi32_epi64(row);
+            high[k] = _mm_cvtepi32_epi64(_mm_srli_si128(row, 8));
+        }
+
+        for (int i = 0; i < 4; i++) {
+            const int* r = a + i * 4;
+            __m128i factor = _mm_set1_epi32(r[0]);
+            __m128i sumLow = _mm_mul_epi32(factor, low[0]);
+            __m128i sumHigh = _mm_mul_epi32(factor, high[0]);
+
+            for (int k = 1; k < 4; k++) {
+                factor = _mm_set1_epi32(r[k]);
+                sumLow = _mm_add_epi64(sumLow, _mm_mul_epi32(factor, low[k]));
+                sumHigh = _mm_add_epi64(sumHigh, _mm_mul_epi32(factor, high[k]));
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), sumLow);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4 + 2), sumHigh);
+        }
+    }
+#endif
+
+#if defined(__AVX2__) || defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    // 4x4 float product: one output row per 128-bit register
+    template <>
+    inline void multiplySmall<4, float, float>(const float* a, const float* b, float* out) {
+        __m128 b0 = _mm_loadu_ps(b);
+        __m128 b1 = _mm_loadu_ps(b + 4);
+        __m128 b2 = _mm_loadu_ps(b + 8);
+        __m128 b3 = _mm_loadu_ps(b + 12);
+
+        for (int i = 0; i < 4; i++) {
+            const float* r = a + i * 4;
+            __m128 row = _mm_mul_ps(_mm_set1_ps(r[0]), b0);
+            row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(r[1]), b1));
+            row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(r[2]), b2));
+            row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(r[3]), b3));
+            _mm_storeu_ps(out + i * 4, row);
+        }
+    }
+#endif
+
+    // Small-size path of multiplyRows: gathers both operands into fixed arrays and runs the
+    // unrolled kernel for size N, then hands each row of sums to store(i, sums)
+    template <int N, typename Accumulator, typename Left, typename Right, typename Store>
+    void multiplySmallRows(const Left& left, const Right& right, Store& store) {
+        typedef typename std::remove_cv<typename std::remove_pointer<decltype(left.row(0))>::type>::type T;
+        T a[N * N];
+        T b[N * N];
+        Accumulator out[N * N];
+
+        for (int i = 0; i < N; i++) {
+            auto leftRow = left.row(i);
+            auto rightRow = right.row(i);
+            for (int j = 0; j < N; j++) {
+                a[i * N + j] = leftRow[j];
+                b[i * N + j] = rightRow[j];
+            }
+        }
+
+        multiplySmall<N, Accumulator>(a, b, out);
+
+        for (int i = 0; i < N; i++) {
+            store(i, static_cast<const Accumulator*>(out + i * N));
+        }
+    }
+
+    // Product kernel: for each row i of left * right, sums the row in Accumulator precision and
+    // hands it to store(i, sums). Square 2x2, 3x3 and 4x4 products go to the unrolled kernels.
+    // Otherwise rows of right are walked contiguously (i-k-j order), so the inner loop is a
+    // multiply-add over a row rather than a strided column walk. The row is summed in the caller's
+    // scratch vector, which only grows, so callers that keep it allocate nothing on repeated products.
+    template <typename Accumulator, typename Left, typename Right, typename Store>
+    void multiplyRows(const Left& left, const Right& right, std::vector<Accumulator>& sums, Store store) {
+        if (left.rows == left.cols && right.cols == left.cols) {
+            switch (left.rows) {
+            case 2:
+                multiplySmallRows<2, Accumulator>(left, right, store);
+                return;
+            case 3:
+                multiplySmallRows<3, Accumulator>(left, right, store);
+                return;
+            case 4:
+                multiplySmallRows<4, Accumulator>(left, right, store);
+                return;
+            }
+        }
+
+        if (sums.size() < static_cast<size_t>(right.cols)) {
+            sums.resize(right.cols);
+        }
+
+        for (int i = 0; i < left.rows; i++) {
+            auto a = left.row(i);
+
+            for (int j = 0; j < right.cols; j++) {
+                sums[j] = Accumulator(0);
+            }
+
+            for (int k = 0; k < left.cols; k++) {
+                Accumulator factor = a[k];
+                auto b = right.row(k);
+
+                for (int j = 0; j < right.cols; j++) {
+                    sums[j] += factor * static_cast<Accumulator>(b[j]);
+                }
+            }
+
+            store(i, static_cast<const Accumulator*>(sums.data()));
+        }
+    }
+
+    // As above with a scratch row of its own
+    template <typename Accumulator, typename Left, typename Right, typename Store>
+    void multiplyRows(const Left& left, const Right& right, Store store) {
+        std::vector<Accumulator> sums;
+        multiplyRows<Accumulator>(left, right, sums, store);
+    }
+
+    // Narrows an accumulated sum back to T, setting overflow when an integer sum lies outside T's range.
+    // A sum accumulated in T itself is returned unchanged.
+    template <typename T, typename Accumulator>
+    inline T narrowSum(Accumulator sum, bool& overflow) {
+        if (std::is_integral<T>::value && !std::is_same<T, Accumulator>::value
+            && (sum > static_cast<Accumulator>(std::numeric_limits<T>::max())
+                || sum < static_cast<Accumulator>(std::numeric_limits<T>::lowest()))) {
+            overflow = true;
+        }
+        return static_cast<T>(sum);
+    }
+
+    // output = left * right, summing in the element type's accumulator. overflow is set when a sum does not fit
+    // back into the element type; sums must stay inside the accumulator's own range, which int callers bound first.
+    template <typename Output, typename Left, typename Right>
+    void multiplyInto(const Left& left, const Right& right, const Output& output, bool& overflow) {
+        typedef typename std::remove_cv<typename std::remove_pointer<decltype(output.row(0))>::type>::type T;
+        typedef typename AccumulatorFor<T>::type Accumulator;
+
+        overflow = false;
+
+        multiplyRows<Accumulator>(left, right, [&](int i, const Accumulator* sums) {
+            auto out = output.row(i);
+            for (int j = 0; j < right.cols; j++) {
+                out[j] = narrowSum<T>(sums[j], overflow);
+            }
+        });
+    }
+
+    // As above for element types summed in their own type, which need no narrowing
+    template <typename Output, typename Left, typename Right>
+    void multiplyInto(const Left& left, const Right& right, const Output& output) {
+        typedef typename std::remove_cv<typename std::remove_pointer<decltype(output.row(0))>::type>::type T;
+        static_assert(std::is_same<T, typename AccumulatorFor<T>::type>::value,
+            "Element types with a wider accumulator must use the overload that reports overflow");
+
+        bool overflow;
+        multiplyInto(left, right, output, overflow);
+    }
+
+    // Nested vector<vector<T>> product, for callers that keep the nested representation
+    template <typename T>
+    std::vector<std::vector<T>> multiply(const std::vector<std::vector<T>>& left, const std::vector<std::vector<T>>& right) {
+        std::vector<std::vector<T>> result(left.size(), std::vector<T>(right[0].size()));
+        multiplyInto(view(left), view(right), view(result));
+        return result;
+    }
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// Thread helpers shared by the calculators.
+// Work is split into one contiguous range per thread. Each calculator picks its own grain, the smallest
+// number of items worth handing to a thread, to suit the cost of one item.
+namespace ParallelCore {
+
+    // Number of threads to use for count items, at most one per grain items and one per hardware thread
+    inline int chooseThreadCount(size_t count, size_t grain) {
+        size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+        size_t useful = count / grain + 1;
+        return static_cast<int>(std::min(hardware, useful));
+    }
+
+    // Runs body(thread, begin, end) over [0, count) split into contiguous ranges, one per thread.
+    // A single thread runs the body on the calling thread.
+    inline void runInParallel(size_t count, int threadCount, const std::function<void(int, size_t, size_t)>& body) {
+        if (threadCount <= 1) {
+            body(0, 0, count);
+            return;
+        }
+
+        std::vector<std::thread> workers;
+        size_t chunk = (count + threadCount - 1) / threadCount;
+
+        for (int t = 0; t < threadCount; t++) {
+            size_t begin = std::min(count, t * chunk);
+            size_t end = std::min(count, begin + chunk);
+            workers.emplace_back(body, t, begin, end);
+        }
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+}
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Quaternion core shared by the calculators.
+// Quaternion<T> is a literal type, so construction and the arithmetic below can run at compile time.
+// T is float, double or long double. The functions that need a square root or a trigonometric
+// function (normalizeQuaternion, slerp) run at run time only.
+// Callers check for zero quaternions before inverting, each with their own error handling.
+namespace QuaternionCore {
+
+    template <typename T>
+    struct Quaternion {
+        typedef T value_type;
+
+        T scalar;
+        T i;
+        T j;
+        T k;
+
+        constexpr Quaternion(T s = T(), T i = T(), T j = T(), T k = T())
+            : scalar(s), i(i), j(j), k(k) {}
+
+        // Conversion between precisions must be asked for
+        template <typename U>
+        constexpr explicit Quaternion(const Quaternion<U>& other)
+            : scalar(static_cast<T>(other.scalar)), i(static_cast<T>(other.i)), j(static_cast<T>(other.j)), k(static_cast<T>(other.k)) {}
+
+        constexpr Quaternion& operator+=(const Quaternion& other) {
+            scalar += other.scalar;
+            i += other.i;
+            j += other.j;
+            k += other.k;
+            return *this;
+        }
+
+        constexpr Quaternion& operator-=(const Quaternion& other) {
+            scalar -= other.scalar;
+            i -= other.i;
+            j -= other.j;
+            k -= other.k;
+            return *this;
+        }
+
+        constexpr Quaternion& operator*=(T factor) {
+            scalar *= factor;
+            i *= factor;
+            j *= factor;
+            k *= factor;
+            return *this;
+        }
+    };
+
+    typedef Quaternion<float> QuaternionF;
+    typedef Quaternion<double> QuaternionD;
+    typedef Quaternion<long double> QuaternionLD;
+
+    template <typename T>
+    constexpr Quaternion<T> addQuaternions(const Quaternion<T>& a, const Quaternion<T>& b) {
+        return Quaternion<T>(a.scalar + b.scalar, a.i + b.i, a.j + b.j, a.k + b.k);
+    }
+
+    template <typename T>
+    constexpr Quaternion<T> subtractQuaternions(const Quaternion<T>& a, const Quaternion<T>& b) {
+        return Quaternion<T>(a.scalar - b.scalar, a.i - b.i, a.j - b.j, a.k - b.k);
+    }
+
+    // Hamilton product a * b
+    template <typename T>
+    constexpr Quaternion<T> multiplyQuaternions(const Quaternion<T>& a, const Quaternion<T>& b) {
+        return Quaternion<T>(
+            a.scalar * b.scalar - a.i * b.i - a.j * b.j - a.k * b.k,
+            a.scalar * b.i + a.i * b.scalar + a.j * b.k - a.k * b.j,
+            a.scalar * b.j - a.i * b.k + a.j * b.scalar + a.k * b.i,
+            a.scalar * b.k + a.i * b.j - a.j * b.i + a.k * b.scalar);
+    }
+
+    template <typename T>
+    constexpr T calculateDotProduct(const Quaternion<T>& a, const Quaternion<T>& b) {
+        return a.scalar * b.scalar + a.i * b.i + a.j * b.j + a.k * b.k;
+    }
+
+    template <typename T>
+    constexpr Quaternion<T> calculateConjugate(const Quaternion<T>& quaternion) {
+        return Quaternion<T>(quaternion.scalar, -quaternion.i, -quaternion.j, -quaternion.k);
+    }
+
+    // Scalar arguments are not deduced, so multiplyByScalar(q, 2) works for any T
+    template <typename T>
+    constexpr Quaternion<T> multiplyByScalar(const Quaternion<T>& quaternion, typename Quaternion<T>::value_type factor) {
+        return Quaternion<T>(quaternion.scalar * factor, quaternion.i * factor, quaternion.j * factor, quaternion.k * factor);
+    }
+
+    // conjugate / |q|^2; the quaternion must not be zero
+    template <typename T>
+    constexpr Quaternion<T> calculateInverse(const Quaternion<T>& quaternion) {
+        return multiplyByScalar(calculateConjugate(quaternion), T(1) / calculateDotProduct(quaternion, quaternion));
+    }
+
+    template <typename T>
+    constexpr Quaternion<T> operator+(const Quaternion<T>& a, const Quaternion<T>& b) {
+        return addQuaternions(a, b);
+    }
+
+    template <typename T>
+    constexpr Quaternion<T> operator-(const Quaternion<T>& a, const Quaternion<T>& b) {
+        return subtractQuaternions(a, b);
+    }
+
+    template <typename T>
+    constexpr Quaternion<T> operator-(const Quaternion<T>& quaternion) {
+        return Quaternion<T>(-quaternion.scalar, -quaternion.i, -quaternion.j, -quaternion.k);
+    }
+
+    template <typename T>
+    constexpr Quaternion<T> operator*(const Quaternion<T>& a, const Quaternion<T>& b) {
+        return multiplyQuaternions(a, b);
+    }
+
+    template <typename T>
+    constexpr Quaternion<T> operator*(const Quaternion<T>& quaternion, typename Quaternion<T>::value_type factor) {
+        return multiplyByScalar(quaternion, factor);
+    }
+
+    template <typename T>
+    constexpr Quaternion<T> operator*(typename Quaternion<T>::value_type factor, const Quaternion<T>& quaternion) {
+        return multiplyByScalar(quaternion, factor);
+    }
+
+    template <typename T>
+    constexpr bool operator==(const Quaternion<T>& a, const Quaternion<T>& b) {
+        return a.scalar == b.scalar && a.i == b.i && a.j == b.j && a.k == b.k;
+    }
+
+    template <typename T>
+    constexpr bool operator!=(const Quaternion<T>& a, const Quaternion<T>& b) {
+        return !(a == b);
+    }
+
+    // Scale to unit length; the zero quaternion is returned unchanged
+    template <typename T>
+    inline Quaternion<T> normalizeQuaternion(const Quaternion<T>& quaternion) {
+        T normSquared = calculateDotProduct(quaternion, quaternion);
+
+        if (normSquared == T(0)) {
+            return quaternion;
+        }
+
+        return multiplyByScalar(quaternion, T(1) / std::sqrt(normSquared));
+    }
+
+    // Spherical linear interpolation between unit quaternions from a (t = 0) to b (t = 1), along the shorter arc
+    // when shorterArc is set and along the arc from a to b as given otherwise.
+    // There is no recursion and no branch on the inputs, so every call costs the same:
+    // - the shorter arc is taken by giving b's weight the sign of a . b;
+    // - the relative rotation conj(a) b has cos(theta) = a . b as its scalar part and sin(theta) as the length of
+    //   its vector part, so theta = atan2(sin(theta), a . b) is accurate at every angle, unlike acos(a . b);
+    // - below sin(theta) = 0.001 the weights blend towards linear ones (1 - t, t) instead of switching to them,
+    //   so the result is continuous and the 0 / 0 at theta = 0 never contributes.
+    template <typename T>
+    inline Quaternion<T> slerpOnArc(const Quaternion<T>& a, const Quaternion<T>& b, T t, bool shorterArc) {
+        const T threshold = T(0.001);
+
+        Quaternion<T> relative = multiplyQuaternions(calculateConjugate(a), b);
+        T sign = shorterArc ? std::copysign(T(1), relative.scalar) : T(1);
+        T sinTheta = std::sqrt(relative.i * relative.i + relative.j * relative.j + relative.k * relative.k);
+        T theta = std::atan2(sinTheta, sign * relative.scalar);
+
+        // 0 at theta = 0 and 1 from the threshold on; the smallest normal denominator keeps the weights finite
+        T blend = std::min(sinTheta / threshold, T(1));
+        T inverseSinTheta = T(1) / std::max(sinTheta, std::numeric_limits<T>::min());
+
+        T s1 = blend * std::sin((T(1) - t) * theta) * inverseSinTheta + (T(1) - blend) * (T(1) - t);
+        T s2 = blend * std::sin(t * theta) * inverseSinTheta + (T(1) - blend) * t;
+
+        return normalizeQuaternion(multiplyByScalar(a, s1) + multiplyByScalar(b, sign * s2));
+    }
+
+    // Slerp along the shorter arc, so q and -q, which are the same rotation, interpolate the same way
+    template <typename T>
+    inline Quaternion<T> slerp(const Quaternion<T>& a, const Quaternion<T>& b, typename Quaternion<T>::value_type t) {
+        return slerpOnArc(a, b, t, true);
+    }
+
+    // Slerp along the arc from a to b as given, never negating b. Curves built from nested slerps (SQUAD, spherical
+    // Bezier) need this once their keys are in one hemisphere chain: the inner points can drift more than 90 degrees
+    // apart, and flipping one of them partway along a segment makes the curve jump. Undefined at b = -a.
+    template <typename T>
+    inline Quaternion<T> slerpWithoutFlip(const Quaternion<T>& a, const Quaternion<T>& b, typename Quaternion<T>::value_type t) {
+        return slerpOnArc(a, b, t, false);
+    }
+}
@@ -4,6 +4,8 @@
 #include <vector>
 #include <cmath>
 
+#include "../../Common/MatrixCore.h"
+
 using namespace std;
 
 typedef vector<double> Row;
@@ -64,16 +66,12 @@ void displayMatrix(const Matrix& matrix) {
 
 // Function to perform the elementary row operation - Multiply a row by a scalar
 void multiplyRowByScalar(Row& row, double scalar) {
-    for (double& value : row) {
-        value *= scalar;
-    }
+    MatrixCore::scaleRow(row.data(), row.size(), scalar);
 }
 
 // Function to perform the elementary row operation - Add a multiple of one row to another row
 void addMultipleOfRowToRow(Row& row1, const Row& row2, double scalar) {
-    for (size_t i = 0; i < row1.size(); i++) {
-        row1[i] += scalar * row2[i];
-    }
+    MatrixCore::addScaledRow(row1.data(), row2.data(), row1.size(), scalar);
 }
 
 // Function to find the pivot element index in a column for Gaussian elimination
@@ -1,11 +1,27 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
+#include "../../Common/MatrixCore.h"
+#include "../../Common/ParallelCore.h"
 
 using namespace std;
 
 // Function to display a matrix
-void displayMatrix(const vector<vector<int>>& matrix) {
+template <typename T>
+void displayMatrix(const vector<vector<T>>& matrix) {
     for (const auto& row : matrix) {
         for (const auto& element : row) {
             cout << element << " ";
@@ -19,22 +35,168 @@ int calculateDeterminant(const vector<vector<int>>& matrix) {
     return matrix[0][0] * matrix[1][1] - matrix[0][1] * matrix[1][0];
 }
 
+// Side of the square tiles used by the blocked transposes: 16 ints fill one 64-byte cache line
+const int TRANSPOSE_TILE = 16;
+
+// Function to transpose the 4x4 block at (row, col) of src into (col, row) of dst
+inline void transpose4x4(const int* const* src, int* const* dst, int row, int col) {
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    __m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[row] + col));
+    __m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[row + 1] + col));
+    __m128i r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[row + 2] + col));
+    __m128i r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[row + 3] + col));
+
+    __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+    __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+    __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+    __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst[col] + row), _mm_unpacklo_epi64(t0, t1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst[col + 1] + row), _mm_unpackhi_epi64(t0, t1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst[col + 2] + row), _mm_unpacklo_epi64(t2, t3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst[col + 3] + row), _mm_unpackhi_epi64(t2, t3));
+#else
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            dst[col + j][row + i] = src[row + i][col + j];
+        }
+    }
+#endif
+}
+
+// Function to transpose a rows x cols matrix given as row pointers into dst, tile by tile
+void transposeBlocked(const int* const* src, int* const* dst, int rows, int cols) {
+    for (int ii = 0; ii < rows; ii += TRANSPOSE_TILE) {
+        int iEnd = min(rows, ii + TRANSPOSE_TILE);
+
+        for (int jj = 0; jj < cols; jj += TRANSPOSE_TILE) {
+            int jEnd = min(cols, jj + TRANSPOSE_TILE);
+            int i = ii;
+
+            for (; i + 4 <= iEnd; i += 4) {
+                int j = jj;
+                for (; j + 4 <= jEnd; j += 4) {
+                    transpose4x4(src, dst, i, j);
+                }
+                for (; j < jEnd; j++) {
+                    for (int r = i; r < i + 4; r++) {
+                        dst[j][r] = src[r][j];
+                    }
+                }
+            }
+
+            for (; i < iEnd; i++) {
+                for (int j = jj; j < jEnd; j++) {
+                    dst[j][i] = src[i][j];
+                }
+            }
+        }
+    }
+}
+
 // Function to transpose a matrix
 vector<vector<int>> transposeMatrix(const vector<vector<int>>& matrix) {
     int rows = matrix.size();
     int cols = matrix[0].size();
 
     vector<vector<int>> result(cols, vector<int>(rows));
+    vector<const int*> srcRows(rows);
+    vector<int*> dstRows(cols);
 
     for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            result[j][i] = matrix[i][j];
-        }
+        srcRows[i] = matrix[i].data();
+    }
+    for (int j = 0; j < cols; j++) {
+        dstRows[j] = result[j].data();
     }
 
+    transposeBlocked(srcRows.data(), dstRows.data(), rows, cols);
+
     return result;
 }
 
+// Function to transpose a row-major contiguous matrix into a separate buffer
+void transposeContiguous(const int* src, int* dst, int rows, int cols) {
+    vector<const int*> srcRows(rows);
+    vector<int*> dstRows(cols);
+
+    for (int i = 0; i < rows; i++) {
+        srcRows[i] = src + static_cast<size_t>(i) * cols;
+    }
+    for (int j = 0; j < cols; j++) {
+        dstRows[j] = dst + static_cast<size_t>(j) * rows;
+    }
+
+    transposeBlocked(srcRows.data(), dstRows.data(), rows, cols);
+}
+
+// Function to transpose a square matrix in place, swapping mirrored tiles across the diagonal
+void transposeSquareInPlace(vector<vector<int>>& matrix) {
+    int size = matrix.size();
+
+    if (size == 0 || static_cast<int>(matrix[0].size()) != size) {
+        cerr << "Error: In-place transpose requires a square matrix." << endl;
+        exit(1);
+    }
+
+    for (int ii = 0; ii < size; ii += TRANSPOSE_TILE) {
+        int iEnd = min(size, ii + TRANSPOSE_TILE);
+
+        // Diagonal tile: swap its strict upper triangle with its lower triangle
+        for (int i = ii; i < iEnd; i++) {
+            for (int j = i + 1; j < iEnd; j++) {
+                swap(matrix[i][j], matrix[j][i]);
+            }
+        }
+
+        // Off-diagonal tiles: swap tile (ii, jj) with tile (jj, ii) while both are in cache
+        for (int jj = iEnd; jj < size; jj += TRANSPOSE_TILE) {
+            int jEnd = min(size, jj + TRANSPOSE_TILE);
+
+            for (int i = ii; i < iEnd; i++) {
+                for (int j = jj; j < jEnd; j++) {
+                    swap(matrix[i][j], matrix[j][i]);
+                }
+            }
+        }
+    }
+}
+
+// Function to transpose a row-major contiguous rows x cols matrix in place by following permutation cycles
+void transposeInPlace(vector<int>& data, int rows, int cols) {
+    size_t count = static_cast<size_t>(rows) * cols;
+
+    if (data.size() != count) {
+        cerr << "Error: Matrix data does not match the given dimensions." << endl;
+        exit(1);
+    }
+
+    if (count < 3) {
+        return;
+    }
+
+    // Element at index p moves to (p * rows) mod (count - 1); the first and last elements stay put.
+    // One bit per element records which positions have already been placed.
+    size_t modulus = count - 1;
+    vector<bool> visited(count);
+
+    for (size_t start = 1; start < modulus; start++) {
+        if (visited[start]) {
+            continue;
+        }
+
+        size_t position = start;
+        int carried = data[start];
+
+        do {
+            size_t destination = (position * rows) % modulus;
+            swap(carried, data[destination]);
+            visited[destination] = true;
+            position = destination;
+        } while (position != start);
+    }
+}
+
 // Function to calculate the inverse of a matrix
 vector<vector<int>> calculateInverse(const vector<vector<int>>& matrix) {
     int determinant = calculateDeterminant(matrix);
@@ -70,11 +232,7 @@ vector<vector<int>> multiplyByScalar(const vector<vector<int>>& matrix, int scal
 
     vector<vector<int>> result(rows, vector<int>(cols));
 
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            result[i][j] = matrix[i][j] * scalar;
-        }
-    }
+    MatrixCore::scaleInto(MatrixCore::view(matrix), scalar, MatrixCore::view(result));
 
     return result;
 }
@@ -86,11 +244,7 @@ vector<vector<int>> addMatrices(const vector<vector<int>>& matrix1, const vector
 
     vector<vector<int>> result(rows, vector<int>(cols));
 
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            result[i][j] = matrix1[i][j] + matrix2[i][j];
-        }
-    }
+    MatrixCore::addInto(MatrixCore::view(matrix1), MatrixCore::view(matrix2), MatrixCore::view(result));
 
     return result;
 }
@@ -102,54 +256,2006 @@ vector<vector<int>> subtractMatrices(const vector<vector<int>>& matrix1, const v
 
     vector<vector<int>> result(rows, vector<int>(cols));
 
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-            result[i][j] = matrix1[i][j] - matrix2[i][j];
+    MatrixCore::subtractInto(MatrixCore::view(matrix1), MatrixCore::view(matrix2), MatrixCore::view(result));
+
+    return result;
+}
+
+// Accumulation policy that widens int products to 64 bits and keeps the wide sum
+struct WideningPolicy {
+    typedef int Input;
+    typedef long long Accumulator;
+    typedef long long Output;
+
+    static Output narrow(Accumulator sum, bool& /*overflow*/) {
+        return sum;
+    }
+};
+
+// Accumulation policy that widens int products to 64 bits and clamps the sum to the int range
+struct SaturatingPolicy {
+    typedef int Input;
+    typedef long long Accumulator;
+    typedef int Output;
+
+    static Output narrow(Accumulator sum, bool& /*overflow*/) {
+        if (sum > INT_MAX) {
+            return INT_MAX;
+        }
+        if (sum < INT_MIN) {
+            return INT_MIN;
         }
+        return static_cast<int>(sum);
     }
+};
 
-    return result;
+// Accumulation policy that widens int products to 64 bits and flags sums outside the int range
+struct CheckedPolicy {
+    typedef int Input;
+    typedef long long Accumulator;
+    typedef int Output;
+
+    static Output narrow(Accumulator sum, bool& overflow) {
+        if (sum > INT_MAX || sum < INT_MIN) {
+            overflow = true;
+        }
+        return static_cast<int>(sum);
+    }
+};
+
+// Function to find the largest value of a signed integer accumulator
+template <typename Accumulator>
+inline Accumulator largestAccumulatorValue() {
+    Accumulator half = Accumulator(1) << (sizeof(Accumulator) * CHAR_BIT - 2);
+    return (half - 1) + half;
 }
 
-// Function to multiply two matrices
-vector<vector<int>> multiplyMatrices(const vector<vector<int>>& matrix1, const vector<vector<int>>& matrix2) {
-    int rows1 = matrix1.size();
-    int cols1 = matrix1[0].size();
-    int rows2 = matrix2.size();
-    int cols2 = matrix2[0].size();
+// Function to add a term to a sum, wrapping around on overflow.
+// Returns 1 or -1 when the sum wrapped past the top or the bottom of the accumulator's range, and 0 otherwise.
+template <typename Accumulator>
+inline int addWrapping(Accumulator& sum, Accumulator term) {
+#if defined(__GNUC__)
+    if (__builtin_add_overflow(sum, term, &sum)) {
+        return term > 0 ? 1 : -1;
+    }
+    return 0;
+#else
+    // Without the builtin only long long accumulators exist, and unsigned addition wraps
+    Accumulator wrapped = static_cast<Accumulator>(static_cast<unsigned long long>(sum) + static_cast<unsigned long long>(term));
+    int wraps = term > 0 && wrapped < sum ? 1 : (term < 0 && wrapped > sum ? -1 : 0);
+    sum = wrapped;
+    return wraps;
+#endif
+}
 
-    if (cols1 != rows2) {
-        cerr << "Error: Matrix dimensions are not compatible for multiplication." << endl;
-        exit(1);
+// Function to find the largest magnitude among the entries of a matrix view, as a double
+template <typename View>
+double largestMagnitude(const View& matrix) {
+    double largest = 0;
+    for (int i = 0; i < matrix.rows; i++) {
+        auto row = matrix.row(i);
+        for (int j = 0; j < matrix.cols; j++) {
+            largest = max(largest, row[j] < 0 ? -static_cast<double>(row[j]) : static_cast<double>(row[j]));
+        }
+    }
+    return largest;
+}
+
+// Function to find the largest magnitude among count values, as a double
+inline double largestMagnitude(const int* values, int count) {
+    double largest = 0;
+    for (int i = 0; i < count; i++) {
+        largest = max(largest, values[i] < 0 ? -static_cast<double>(values[i]) : static_cast<double>(values[i]));
+    }
+    return largest;
+}
+
+// Function to tell whether a sum of the given number of products of entries at most largest1 and largest2 in magnitude stays well
+// inside the accumulator's range. Half the range is kept as margin for the rounding of the double estimate.
+template <typename Accumulator>
+inline bool accumulatorCannotOverflow(double terms, double largest1, double largest2) {
+    return terms * largest1 * largest2 <= 0.5 * static_cast<double>(largestAccumulatorValue<Accumulator>());
+}
+
+// Structure to hold the working rows of a matrix product, kept by callers that multiply repeatedly
+template <typename Accumulator>
+struct ProductScratch {
+    vector<Accumulator> sums;
+    vector<int> wraps;
+};
+
+// Function to multiply two matrix views into an output view of the product's shape, accumulating each entry as
+// described by the policy. The working rows live in scratch, so repeating a product of the same shape allocates
+// nothing. The output must not alias either input, and the caller checks the dimensions.
+// overflow is also set when a sum leaves the accumulator's range; the policy then narrows the saturated sum.
+template <typename Policy, typename Left, typename Right, typename Output>
+void multiplyViewsWithInto(const Left& left, const Right& right, const Output& output,
+    ProductScratch<typename Policy::Accumulator>& scratch, bool& overflow) {
+    typedef typename Policy::Accumulator Accumulator;
+
+    int rows1 = left.rows;
+    int cols1 = left.cols;
+    int cols2 = right.cols;
+
+    overflow = false;
+
+    if (accumulatorCannotOverflow<Accumulator>(cols1, largestMagnitude(left), largestMagnitude(right))) {
+        // The shared kernel widens each product to the accumulator type; the policy narrows each finished row
+        MatrixCore::multiplyRows<Accumulator>(left, right, scratch.sums, [&](int i, const Accumulator* sums) {
+            auto out = output.row(i);
+            for (int j = 0; j < cols2; j++) {
+                out[j] = Policy::narrow(sums[j], overflow);
+            }
+        });
+        return;
     }
 
-    vector<vector<int>> result(rows1, vector<int>(cols2));
+    // Entries large enough to overflow the accumulator: count how often each sum wraps. A sum that wrapped
+    // a net nonzero number of times is outside the accumulator's range, whatever the later terms did.
+    const Accumulator largest = largestAccumulatorValue<Accumulator>();
+    vector<Accumulator>& sums = scratch.sums;
+    vector<int>& wraps = scratch.wraps;
+    sums.resize(max<size_t>(sums.size(), cols2));
+    wraps.resize(max<size_t>(wraps.size(), cols2));
 
     for (int i = 0; i < rows1; i++) {
+        auto a = left.row(i);
+        auto out = output.row(i);
+        fill(sums.begin(), sums.begin() + cols2, Accumulator(0));
+        fill(wraps.begin(), wraps.begin() + cols2, 0);
+
+        for (int k = 0; k < cols1; k++) {
+            Accumulator factor = a[k];
+            auto row = right.row(k);
+
+            for (int j = 0; j < cols2; j++) {
+                wraps[j] += addWrapping(sums[j], factor * static_cast<Accumulator>(row[j]));
+            }
+        }
+
         for (int j = 0; j < cols2; j++) {
-            for (int k = 0; k < cols1; k++) {
-                result[i][j] += matrix1[i][k] * matrix2[k][j];
+            if (wraps[j] != 0) {
+                overflow = true;
+                sums[j] = wraps[j] > 0 ? largest : -largest - 1;
             }
+            out[j] = Policy::narrow(sums[j], overflow);
         }
     }
+}
+
+// Function to multiply two matrices into an existing result, accumulating each entry as described by the policy.
+// The result keeps its storage when it already has the right shape, so with a kept scratch a repeated product
+// of the same shape allocates nothing. The result must not alias either input.
+template <typename Policy>
+void multiplyMatricesWithInto(const vector<vector<typename Policy::Input>>& matrix1,
+    const vector<vector<typename Policy::Input>>& matrix2, vector<vector<typename Policy::Output>>& result,
+    ProductScratch<typename Policy::Accumulator>& scratch, bool& overflow) {
+    if (matrix1[0].size() != matrix2.size()) {
+        cerr << "Error: Matrix dimensions are not compatible for multiplication." << endl;
+        exit(1);
+    }
+
+    result.resize(matrix1.size());
+    for (auto& row : result) {
+        row.resize(matrix2[0].size());
+    }
+
+    multiplyViewsWithInto<Policy>(MatrixCore::view(matrix1), MatrixCore::view(matrix2), MatrixCore::view(result), scratch, overflow);
+}
+
+// Function to multiply two matrices, accumulating each entry as described by the policy
+template <typename Policy>
+vector<vector<typename Policy::Output>> multiplyMatricesWith(const vector<vector<typename Policy::Input>>& matrix1,
+    const vector<vector<typename Policy::Input>>& matrix2, bool& overflow) {
+    vector<vector<typename Policy::Output>> result;
+    ProductScratch<typename Policy::Accumulator> scratch;
+    multiplyMatricesWithInto<Policy>(matrix1, matrix2, result, scratch, overflow);
+    return result;
+}
+
+// Function to multiply two matrices
+vector<vector<int>> multiplyMatrices(const vector<vector<int>>& matrix1, const vector<vector<int>>& matrix2) {
+    bool overflow;
+    vector<vector<int>> result = multiplyMatricesWith<CheckedPolicy>(matrix1, matrix2, overflow);
+
+    if (overflow) {
+        cerr << "Error: Matrix product overflows the integer range." << endl;
+        exit(1);
+    }
 
     return result;
 }
 
+// Function to multiply two contiguous matrices into an existing result, reshaped only when its shape differs, so
+// with a kept scratch a repeated product of the same shape allocates nothing. The result must not alias either input.
+void multiplyMatricesInto(const MatrixCore::DenseMatrix<int>& matrix1, const MatrixCore::DenseMatrix<int>& matrix2,
+    MatrixCore::DenseMatrix<int>& result, ProductScratch<long long>& scratch) {
+    if (matrix1.cols != matrix2.rows) {
+        cerr << "Error: Matrix dimensions are not compatible for multiplication." << endl;
+        exit(1);
+    }
+
+    if (result.rows != matrix1.rows || result.cols != matrix2.cols) {
+        result = MatrixCore::DenseMatrix<int>(matrix1.rows, matrix2.cols);
+    }
+
+    bool overflow;
+    multiplyViewsWithInto<CheckedPolicy>(MatrixCore::view(matrix1), MatrixCore::view(matrix2), MatrixCore::view(result), scratch, overflow);
+
+    if (overflow) {
+        cerr << "Error: Matrix product overflows the integer range." << endl;
+        exit(1);
+    }
+}
+
+// Function to display the product of two matrices, accumulated as chosen on the command line:
+// --wide keeps the 64-bit sums, --saturate clamps them to the int range, and otherwise overflow is an error
+void displayProduct(const vector<vector<int>>& matrix1, const vector<vector<int>>& matrix2, const string& accumulation) {
+    bool overflow;
+
+    if (accumulation == "--wide") {
+        vector<vector<long long>> product = multiplyMatricesWith<WideningPolicy>(matrix1, matrix2, overflow);
+
+        if (overflow) {
+            cerr << "Error: Matrix product overflows the 64-bit integer range." << endl;
+            exit(1);
+        }
+
+        displayMatrix(product);
+    } else if (accumulation == "--saturate") {
+        displayMatrix(multiplyMatricesWith<SaturatingPolicy>(matrix1, matrix2, overflow));
+    } else {
+        displayMatrix(multiplyMatrices(matrix1, matrix2));
+    }
+}
+
 // Function to generate an identity matrix
 vector<vector<int>> generateIdentityMatrix(int size) {
     vector<vector<int>> identity(size, vector<int>(size));
 
+    // Rows start zero-filled, so only the diagonal needs writing
     for (int i = 0; i < size; i++) {
-        for (int j = 0; j < size; j++) {
-            identity[i][j] = (i == j) ? 1 : 0;
-        }
+        identity[i][i] = 1;
     }
 
     return identity;
 }
 
-int main() {
+// Structure to represent a size x size identity matrix without storing it
+struct IdentityMatrix {
+    int size;
+};
+
+// Structure to represent a size x size multiple of the identity matrix without storing it
+struct ScalarMatrix {
+    int size;
+    int scalar;
+};
+
+// Structure to represent a diagonal matrix by its diagonal entries
+struct DiagonalMatrix {
+    vector<int> diagonal;
+};
+
+// Function to check that order holds each of 0..N-1 exactly once, in O(N) with one flag per index
+void checkPermutation(const vector<int>& order) {
+    int size = order.size();
+    vector<bool> seen(size);
+
+    for (int index : order) {
+        if (index < 0 || index >= size || seen[index]) {
+            cerr << "Error: Permutation must hold each index from 0 to " << size - 1 << " exactly once." << endl;
+            exit(1);
+        }
+        seen[index] = true;
+    }
+}
+
+// Structure to represent a permutation matrix: row i has its single 1 in column permutation[i].
+// The order is checked when the matrix is built, so every index is in range and appears once.
+struct PermutationMatrix {
+    vector<int> permutation;
+
+    explicit PermutationMatrix(vector<int> order)
+        : permutation(move(order)) {
+        checkPermutation(permutation);
+    }
+};
+
+// Function to check that a square structured matrix of the given size fits a dense matrix dimension
+void checkStructuredSize(int size, int dimension) {
+    if (size != dimension) {
+        cerr << "Error: Matrix dimensions are not compatible for multiplication." << endl;
+        exit(1);
+    }
+}
+
+// Function to add two ints, stopping with an error if the sum overflows
+inline int addChecked(int a, int b) {
+    bool overflow = false;
+    int sum = CheckedPolicy::narrow(static_cast<long long>(a) + b, overflow);
+
+    if (overflow) {
+        cerr << "Error: Matrix sum overflows the integer range." << endl;
+        exit(1);
+    }
+
+    return sum;
+}
+
+// Function to multiply two ints, stopping with an error if the product overflows
+inline int multiplyChecked(int a, int b) {
+    bool overflow = false;
+    int product = CheckedPolicy::narrow(static_cast<long long>(a) * b, overflow);
+
+    if (overflow) {
+        cerr << "Error: Matrix product overflows the integer range." << endl;
+        exit(1);
+    }
+
+    return product;
+}
+
+// Function to multiply by the identity on the left, which is a copy
+vector<vector<int>> multiplyMatrices(const IdentityMatrix& identity, const vector<vector<int>>& matrix) {
+    checkStructuredSize(identity.size, matrix.size());
+    return matrix;
+}
+
+// Function to multiply by the identity on the right, which is a copy
+vector<vector<int>> multiplyMatrices(const vector<vector<int>>& matrix, const IdentityMatrix& identity) {
+    checkStructuredSize(identity.size, matrix[0].size());
+    return matrix;
+}
+
+// Function to multiply by a scalar matrix on the left in O(N^2)
+vector<vector<int>> multiplyMatrices(const ScalarMatrix& scalarMatrix, const vector<vector<int>>& matrix) {
+    checkStructuredSize(scalarMatrix.size, matrix.size());
+
+    vector<vector<int>> result = matrix;
+    for (auto& row : result) {
+        for (int& value : row) {
+            value = multiplyChecked(value, scalarMatrix.scalar);
+        }
+    }
+
+    return result;
+}
+
+// Function to multiply by a scalar matrix on the right in O(N^2)
+vector<vector<int>> multiplyMatrices(const vector<vector<int>>& matrix, const ScalarMatrix& scalarMatrix) {
+    checkStructuredSize(scalarMatrix.size, matrix[0].size());
+    return multiplyMatrices(ScalarMatrix{ static_cast<int>(matrix.size()), scalarMatrix.scalar }, matrix);
+}
+
+// Function to multiply by a diagonal matrix on the left, scaling each row, in O(N^2)
+vector<vector<int>> multiplyMatrices(const DiagonalMatrix& diagonalMatrix, const vector<vector<int>>& matrix) {
+    checkStructuredSize(diagonalMatrix.diagonal.size(), matrix.size());
+
+    vector<vector<int>> result = matrix;
+    for (size_t i = 0; i < result.size(); i++) {
+        int factor = diagonalMatrix.diagonal[i];
+        for (int& value : result[i]) {
+            value = multiplyChecked(value, factor);
+        }
+    }
+
+    return result;
+}
+
+// Function to multiply by a diagonal matrix on the right, scaling each column, in O(N^2)
+vector<vector<int>> multiplyMatrices(const vector<vector<int>>& matrix, const DiagonalMatrix& diagonalMatrix) {
+    checkStructuredSize(diagonalMatrix.diagonal.size(), matrix[0].size());
+
+    vector<vector<int>> result = matrix;
+    const int* factors = diagonalMatrix.diagonal.data();
+
+    for (auto& row : result) {
+        for (size_t j = 0; j < row.size(); j++) {
+            row[j] = multiplyChecked(row[j], factors[j]);
+        }
+    }
+
+    return result;
+}
+
+// Function to multiply two diagonal matrices, which multiplies their diagonals, in O(N)
+DiagonalMatrix multiplyMatrices(const DiagonalMatrix& matrix1, const DiagonalMatrix& matrix2) {
+    checkStructuredSize(matrix1.diagonal.size(), matrix2.diagonal.size());
+
+    DiagonalMatrix result;
+    result.diagonal.resize(matrix1.diagonal.size());
+
+    for (size_t i = 0; i < result.diagonal.size(); i++) {
+        result.diagonal[i] = multiplyChecked(matrix1.diagonal[i], matrix2.diagonal[i]);
+    }
+
+    return result;
+}
+
+// Function to multiply by a permutation matrix on the left, reordering the rows.
+// Taking the matrix by value lets callers move it in, so the rows themselves are moved, not copied, in O(N).
+vector<vector<int>> multiplyMatrices(const PermutationMatrix& permutationMatrix, vector<vector<int>> matrix) {
+    checkStructuredSize(permutationMatrix.permutation.size(), matrix.size());
+
+    vector<vector<int>> result(matrix.size());
+    for (size_t i = 0; i < result.size(); i++) {
+        result[i] = move(matrix[permutationMatrix.permutation[i]]);
+    }
+
+    return result;
+}
+
+// Function to multiply by a permutation matrix on the right, reordering the columns, in O(N^2)
+vector<vector<int>> multiplyMatrices(const vector<vector<int>>& matrix, const PermutationMatrix& permutationMatrix) {
+    checkStructuredSize(permutationMatrix.permutation.size(), matrix[0].size());
+
+    // Column permutation[j] of the result is column j of the matrix
+    vector<vector<int>> result(matrix.size(), vector<int>(matrix[0].size()));
+    const int* permutation = permutationMatrix.permutation.data();
+
+    for (size_t i = 0; i < matrix.size(); i++) {
+        for (size_t j = 0; j < matrix[i].size(); j++) {
+            result[i][permutation[j]] = matrix[i][j];
+        }
+    }
+
+    return result;
+}
+
+// Function to compose two permutation matrices in O(N)
+PermutationMatrix multiplyMatrices(const PermutationMatrix& matrix1, const PermutationMatrix& matrix2) {
+    checkStructuredSize(matrix1.permutation.size(), matrix2.permutation.size());
+
+    vector<int> order(matrix1.permutation.size());
+
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = matrix2.permutation[matrix1.permutation[i]];
+    }
+
+    return PermutationMatrix(move(order));
+}
+
+// Function to add a scalar matrix to a matrix, touching only the diagonal
+vector<vector<int>> addMatrices(const vector<vector<int>>& matrix, const ScalarMatrix& scalarMatrix) {
+    checkStructuredSize(scalarMatrix.size, matrix.size());
+    checkStructuredSize(scalarMatrix.size, matrix[0].size());
+
+    vector<vector<int>> result = matrix;
+    for (int i = 0; i < scalarMatrix.size; i++) {
+        result[i][i] = addChecked(result[i][i], scalarMatrix.scalar);
+    }
+
+    return result;
+}
+
+// Function to add a diagonal matrix to a matrix, touching only the diagonal
+vector<vector<int>> addMatrices(const vector<vector<int>>& matrix, const DiagonalMatrix& diagonalMatrix) {
+    checkStructuredSize(diagonalMatrix.diagonal.size(), matrix.size());
+    checkStructuredSize(diagonalMatrix.diagonal.size(), matrix[0].size());
+
+    vector<vector<int>> result = matrix;
+    for (size_t i = 0; i < diagonalMatrix.diagonal.size(); i++) {
+        result[i][i] = addChecked(result[i][i], diagonalMatrix.diagonal[i]);
+    }
+
+    return result;
+}
+
+// Function to build the dense form of a diagonal matrix
+vector<vector<int>> materializeMatrix(const DiagonalMatrix& diagonalMatrix) {
+    int size = diagonalMatrix.diagonal.size();
+    vector<vector<int>> result(size, vector<int>(size));
+
+    for (int i = 0; i < size; i++) {
+        result[i][i] = diagonalMatrix.diagonal[i];
+    }
+
+    return result;
+}
+
+// Function to build the dense form of a scalar matrix
+vector<vector<int>> materializeMatrix(const ScalarMatrix& scalarMatrix) {
+    return materializeMatrix(DiagonalMatrix{ vector<int>(scalarMatrix.size, scalarMatrix.scalar) });
+}
+
+// Function to build the dense form of an identity matrix
+vector<vector<int>> materializeMatrix(const IdentityMatrix& identity) {
+    return generateIdentityMatrix(identity.size);
+}
+
+// Function to build the dense form of a permutation matrix
+vector<vector<int>> materializeMatrix(const PermutationMatrix& permutationMatrix) {
+    int size = permutationMatrix.permutation.size();
+    vector<vector<int>> result(size, vector<int>(size));
+
+    for (int i = 0; i < size; i++) {
+        result[i][permutationMatrix.permutation[i]] = 1;
+    }
+
+    return result;
+}
+
+// Function to check that an output view has the shape of the result written into it
+void checkOutputSize(const MatrixCore::MatrixView<int>& output, int rows, int cols) {
+    if (output.rows != rows || output.cols != cols) {
+        cerr << "Error: Output matrix dimensions do not match the result." << endl;
+        exit(1);
+    }
+}
+
+// Function to multiply two matrices elementwise into a preallocated contiguous output
+void hadamardProductInto(const vector<vector<int>>& matrix1, const vector<vector<int>>& matrix2, const MatrixCore::MatrixView<int>& output) {
+    int rows = matrix1.size();
+    int cols = matrix1[0].size();
+
+    if (static_cast<int>(matrix2.size()) != rows || static_cast<int>(matrix2[0].size()) != cols) {
+        cerr << "Error: Matrix dimensions are not compatible for an elementwise product." << endl;
+        exit(1);
+    }
+
+    checkOutputSize(output, rows, cols);
+
+    // Products are formed in 64 bits and range-checked branch-free, so the inner loop vectorizes
+    bool overflow = false;
+
+    for (int i = 0; i < rows; i++) {
+        const int* row1 = matrix1[i].data();
+        const int* row2 = matrix2[i].data();
+        int* out = output.row(i);
+        int outside = 0;
+
+        for (int j = 0; j < cols; j++) {
+            long long product = static_cast<long long>(row1[j]) * row2[j];
+            outside |= (product > INT_MAX) | (product < INT_MIN);
+            out[j] = static_cast<int>(product);
+        }
+
+        overflow |= outside != 0;
+    }
+
+    if (overflow) {
+        cerr << "Error: Matrix product overflows the integer range." << endl;
+        exit(1);
+    }
+}
+
+// Function to multiply two matrices elementwise
+vector<vector<int>> hadamardProduct(const vector<vector<int>>& matrix1, const vector<vector<int>>& matrix2) {
+    int rows = matrix1.size();
+    int cols = matrix1[0].size();
+
+    MatrixCore::DenseMatrix<int> output(rows, cols);
+    hadamardProductInto(matrix1, matrix2, MatrixCore::view(output));
+    return MatrixCore::toNested(output);
+}
+
+// Function to compute the Kronecker product into a preallocated contiguous (rows1 * rows2) x (cols1 * cols2) output
+void kroneckerProductInto(const vector<vector<int>>& matrix1, const vector<vector<int>>& matrix2, const MatrixCore::MatrixView<int>& output) {
+    int rows1 = matrix1.size();
+    int cols1 = matrix1[0].size();
+    int rows2 = matrix2.size();
+    int cols2 = matrix2[0].size();
+    bool overflow = false;
+
+    checkOutputSize(output, rows1 * rows2, cols1 * cols2);
+
+    for (int i = 0; i < rows1; i++) {
+        for (int k = 0; k < rows2; k++) {
+            const int* row2 = matrix2[k].data();
+            int* out = output.row(i * rows2 + k);
+            int outside = 0;
+
+            // Each output row is the row of matrix2 scaled by each entry of the row of matrix1 in turn,
+            // formed in 64 bits and range-checked branch-free as in hadamardProductInto
+            for (int j = 0; j < cols1; j++) {
+                long long factor = matrix1[i][j];
+                int* block = out + static_cast<size_t>(j) * cols2;
+
+                for (int l = 0; l < cols2; l++) {
+                    long long product = factor * row2[l];
+                    outside |= (product > INT_MAX) | (product < INT_MIN);
+                    block[l] = static_cast<int>(product);
+                }
+            }
+
+            overflow |= outside != 0;
+        }
+    }
+
+    if (overflow) {
+        cerr << "Error: Matrix product overflows the integer range." << endl;
+        exit(1);
+    }
+}
+
+// Function to compute the Kronecker product of two matrices
+vector<vector<int>> kroneckerProduct(const vector<vector<int>>& matrix1, const vector<vector<int>>& matrix2) {
+    int rows = matrix1.size() * matrix2.size();
+    int cols = matrix1[0].size() * matrix2[0].size();
+
+    MatrixCore::DenseMatrix<int> output(rows, cols);
+    kroneckerProductInto(matrix1, matrix2, MatrixCore::view(output));
+    return MatrixCore::toNested(output);
+}
+
+// Structure to represent the Kronecker product of two matrices without materializing it
+struct KroneckerView {
+    const vector<vector<int>>& left;
+    const vector<vector<int>>& right;
+
+    int rows() const {
+        return left.size() * right.size();
+    }
+
+    int cols() const {
+        return left[0].size() * right[0].size();
+    }
+
+    // Entry (row, col) of the product, exact in 64 bits
+    long long at(int row, int col) const {
+        int rows2 = right.size();
+        int cols2 = right[0].size();
+        return static_cast<long long>(left[row / rows2][col / cols2]) * right[row % rows2][col % cols2];
+    }
+};
+
+// Function to multiply a Kronecker product by a vector without materializing the product.
+// With x viewed as a cols1 x cols2 matrix X, (A (x) B) x is A X B^T read row by row,
+// which costs O(cols1 * cols2 * rows2 + rows1 * cols1 * rows2) instead of O(rows1 * rows2 * cols1 * cols2).
+vector<int> multiplyKroneckerVector(const KroneckerView& view, const vector<int>& vec) {
+    int rows1 = view.left.size();
+    int cols1 = view.left[0].size();
+    int rows2 = view.right.size();
+    int cols2 = view.right[0].size();
+
+    if (static_cast<int>(vec.size()) != cols1 * cols2) {
+        cerr << "Error: Matrix and vector dimensions are not compatible for multiplication." << endl;
+        exit(1);
+    }
+
+    // Every sum below is bounded by cols1 * cols2 * max|A| * max|B| * max|x|. When that is too large for 64 bits
+    // each step is checked; an intermediate that leaves the 64-bit range is reported as overflow even if later
+    // terms would have cancelled it.
+    bool checked = !accumulatorCannotOverflow<long long>(static_cast<double>(cols1) * cols2,
+        largestMagnitude(MatrixCore::view(view.left)) * largestMagnitude(MatrixCore::view(view.right)),
+        largestMagnitude(vec.data(), static_cast<int>(vec.size())));
+    bool overflow = false;
+
+    // partial = X B^T, a cols1 x rows2 matrix
+    vector<long long> partial(static_cast<size_t>(cols1) * rows2);
+
+    for (int p = 0; p < cols1; p++) {
+        const int* x = vec.data() + static_cast<size_t>(p) * cols2;
+
+        for (int s = 0; s < rows2; s++) {
+            const int* row2 = view.right[s].data();
+            long long sum = 0;
+            int wraps = 0;
+
+            for (int q = 0; q < cols2; q++) {
+                wraps += addWrapping(sum, static_cast<long long>(x[q]) * row2[q]);
+            }
+
+            overflow |= wraps != 0;
+            partial[static_cast<size_t>(p) * rows2 + s] = sum;
+        }
+    }
+
+    // result = A partial, a rows1 x rows2 matrix read row by row
+    vector<long long> sums(rows2);
+    vector<int> wraps(rows2);
+    vector<int> result(static_cast<size_t>(rows1) * rows2);
+
+    for (int r = 0; r < rows1; r++) {
+        fill(sums.begin(), sums.end(), 0);
+        fill(wraps.begin(), wraps.end(), 0);
+
+        for (int p = 0; p < cols1; p++) {
+            long long factor = view.left[r][p];
+            const long long* row = partial.data() + static_cast<size_t>(p) * rows2;
+
+            if (!checked) {
+                for (int s = 0; s < rows2; s++) {
+                    sums[s] += factor * row[s];
+                }
+                continue;
+            }
+
+            // |factor| fits in 32 bits, so the product's limit is one division away
+            long long limit = factor == 0 ? LLONG_MAX : LLONG_MAX / (factor < 0 ? -factor : factor);
+
+            for (int s = 0; s < rows2; s++) {
+                if (row[s] > limit || row[s] < -limit) {
+                    overflow = true;
+                    continue;
+                }
+                wraps[s] += addWrapping(sums[s], factor * row[s]);
+            }
+        }
+
+        for (int s = 0; s < rows2; s++) {
+            overflow |= wraps[s] != 0;
+            result[static_cast<size_t>(r) * rows2 + s] = CheckedPolicy::narrow(sums[s], overflow);
+        }
+    }
+
+    if (overflow) {
+        cerr << "Error: Matrix-vector product overflows the integer range." << endl;
+        exit(1);
+    }
+
+    return result;
+}
+
+// Function to check that the rows x cols block starting at (row, col) lies inside the matrix.
+// The ends are compared as matrix size minus block size, which cannot overflow once both are non-negative.
+void checkBlock(const vector<vector<int>>& matrix, int row, int col, int rows, int cols) {
+    int matrixRows = matrix.size();
+    int matrixCols = matrix[0].size();
+
+    if (row < 0 || col < 0 || rows < 0 || cols < 0 || row > matrixRows - rows || col > matrixCols - cols) {
+        cerr << "Error: Block lies outside the matrix." << endl;
+        exit(1);
+    }
+}
+
+// Function to copy the rows x cols block of a matrix starting at (row, col) into a preallocated contiguous output,
+// which may itself be a block of a larger matrix
+void extractBlockInto(const vector<vector<int>>& matrix, int row, int col, int rows, int cols, const MatrixCore::MatrixView<int>& output) {
+    checkBlock(matrix, row, col, rows, cols);
+    checkOutputSize(output, rows, cols);
+
+    for (int i = 0; i < rows; i++) {
+        const int* source = matrix[row + i].data() + col;
+        copy(source, source + cols, output.row(i));
+    }
+}
+
+// Function to extract the rows x cols block of a matrix starting at (row, col)
+vector<vector<int>> extractBlock(const vector<vector<int>>& matrix, int row, int col, int rows, int cols) {
+    checkBlock(matrix, row, col, rows, cols);
+
+    vector<vector<int>> block(rows);
+    for (int i = 0; i < rows; i++) {
+        block[i].assign(matrix[row + i].begin() + col, matrix[row + i].begin() + col + cols);
+    }
+
+    return block;
+}
+
+// Function to check that a grid of blocks can be assembled: every grid row holds the same number of blocks,
+// blocks in a grid row share a height, and every row of the blocks in a grid column has that column's width
+void checkBlockGrid(const vector<vector<vector<vector<int>>>>& blocks) {
+    if (blocks.empty() || blocks[0].empty()) {
+        cerr << "Error: Block grid is empty." << endl;
+        exit(1);
+    }
+
+    size_t gridCols = blocks[0].size();
+
+    for (const auto& gridRow : blocks) {
+        if (gridRow.size() != gridCols) {
+            cerr << "Error: Every row of the block grid must hold the same number of blocks." << endl;
+            exit(1);
+        }
+
+        for (size_t gj = 0; gj < gridCols; gj++) {
+            const vector<vector<int>>& block = gridRow[gj];
+
+            // Grid row 0 is checked first, so the widths of its blocks are safe to read for the later rows
+            if (block.empty() || block.size() != gridRow[0].size()) {
+                cerr << "Error: Block dimensions do not line up." << endl;
+                exit(1);
+            }
+
+            for (const auto& row : block) {
+                if (row.empty() || row.size() != blocks[0][gj][0].size()) {
+                    cerr << "Error: Block dimensions do not line up." << endl;
+                    exit(1);
+                }
+            }
+        }
+    }
+}
+
+// Function to assemble a grid of blocks into a preallocated contiguous output, writing each through a block view.
+// Blocks in a grid row must share a height and blocks in a grid column must share a width.
+void assembleBlocksInto(const vector<vector<vector<vector<int>>>>& blocks, const MatrixCore::MatrixView<int>& output) {
+    checkBlockGrid(blocks);
+
+    int gridRows = blocks.size();
+    int gridCols = blocks[0].size();
+    int totalRows = 0;
+    int totalCols = 0;
+
+    for (int gi = 0; gi < gridRows; gi++) {
+        totalRows += blocks[gi][0].size();
+    }
+    for (int gj = 0; gj < gridCols; gj++) {
+        totalCols += blocks[0][gj][0].size();
+    }
+
+    checkOutputSize(output, totalRows, totalCols);
+
+    int rowBase = 0;
+
+    for (int gi = 0; gi < gridRows; gi++) {
+        int height = blocks[gi][0].size();
+        int colBase = 0;
+
+        for (int gj = 0; gj < gridCols; gj++) {
+            const vector<vector<int>>& block = blocks[gi][gj];
+            int width = block[0].size();
+            MatrixCore::MatrixView<int> target = MatrixCore::block(output, rowBase, colBase, height, width);
+
+            for (int i = 0; i < height; i++) {
+                copy(block[i].begin(), block[i].end(), target.row(i));
+            }
+
+            colBase += width;
+        }
+
+        rowBase += height;
+    }
+}
+
+// Function to assemble a grid of blocks into one matrix
+vector<vector<int>> assembleBlocks(const vector<vector<vector<vector<int>>>>& blocks) {
+    checkBlockGrid(blocks);
+
+    int rows = 0;
+    int cols = 0;
+
+    for (const auto& gridRow : blocks) {
+        rows += gridRow[0].size();
+    }
+    for (const auto& block : blocks[0]) {
+        cols += block[0].size();
+    }
+
+    MatrixCore::DenseMatrix<int> output(rows, cols);
+    assembleBlocksInto(blocks, MatrixCore::view(output));
+    return MatrixCore::toNested(output);
+}
+
+// Function to raise a square matrix to a non-negative power by repeated squaring
+vector<vector<int>> powerMatrix(const vector<vector<int>>& matrix, unsigned long long exponent) {
+    int size = matrix.size();
+
+    if (size == 0 || static_cast<int>(matrix[0].size()) != size) {
+        cerr << "Error: Matrix power requires a square matrix." << endl;
+        exit(1);
+    }
+
+    MatrixCore::DenseMatrix<int> result(size, size);
+    MatrixCore::DenseMatrix<int> base = MatrixCore::toDense(matrix);
+    MatrixCore::DenseMatrix<int> scratch(size, size);
+    ProductScratch<long long> productScratch;
+
+    for (int i = 0; i < size; i++) {
+        result(i, i) = 1;
+    }
+
+    // Three contiguous buffers are swapped around and the product's working rows are reused, so after the
+    // first product nothing is allocated inside the loop
+    while (exponent > 0) {
+        if (exponent & 1) {
+            multiplyMatricesInto(result, base, scratch, productScratch);
+            swap(result, scratch);
+        }
+
+        exponent >>= 1;
+
+        if (exponent > 0) {
+            multiplyMatricesInto(base, base, scratch, productScratch);
+            swap(base, scratch);
+        }
+    }
+
+    return MatrixCore::toNested(result);
+}
+
+// Structure to represent the cheapest parenthesization of a chain of matrix products
+struct MatrixChainPlan {
+    vector<int> dimensions;        // matrix i is dimensions[i] x dimensions[i + 1]
+    vector<vector<int>> split;     // split[i][j]: the product of i..j is (i..split) * (split+1..j)
+    long long plannedCost = 0;     // scalar multiplications of the planned order
+    long long naiveCost = 0;       // scalar multiplications of left-to-right order
+};
+
+// Function to plan the multiplication order of a chain of matrices by dynamic programming
+MatrixChainPlan planMatrixChain(const vector<vector<vector<int>>>& matrices) {
+    int count = matrices.size();
+
+    if (count == 0) {
+        cerr << "Error: Matrix chain is empty." << endl;
+        exit(1);
+    }
+
+    MatrixChainPlan plan;
+    plan.dimensions.push_back(matrices[0].size());
+
+    for (int i = 0; i < count; i++) {
+        if (static_cast<int>(matrices[i].size()) != plan.dimensions.back()) {
+            cerr << "Error: Matrix dimensions are not compatible for multiplication." << endl;
+            exit(1);
+        }
+        plan.dimensions.push_back(matrices[i][0].size());
+    }
+
+    const vector<int>& d = plan.dimensions;
+    vector<vector<long long>> cost(count, vector<long long>(count));
+    plan.split.assign(count, vector<int>(count));
+
+    for (int length = 2; length <= count; length++) {
+        for (int i = 0; i + length - 1 < count; i++) {
+            int j = i + length - 1;
+            cost[i][j] = LLONG_MAX;
+
+            for (int k = i; k < j; k++) {
+                long long candidate = cost[i][k] + cost[k + 1][j] + static_cast<long long>(d[i]) * d[k + 1] * d[j + 1];
+                if (candidate < cost[i][j]) {
+                    cost[i][j] = candidate;
+                    plan.split[i][j] = k;
+                }
+            }
+        }
+    }
+
+    plan.plannedCost = cost[0][count - 1];
+
+    for (int k = 1; k < count; k++) {
+        plan.naiveCost += static_cast<long long>(d[0]) * d[k] * d[k + 1];
+    }
+
+    return plan;
+}
+
+// Function to write the parenthesization of matrices first..last from a plan, e.g. ((M1 M2) M3)
+string describeMatrixChainPlan(const MatrixChainPlan& plan, int first, int last) {
+    if (first == last) {
+        return "M" + to_string(first + 1);
+    }
+
+    int k = plan.split[first][last];
+    return "(" + describeMatrixChainPlan(plan, first, k) + " " + describeMatrixChainPlan(plan, k + 1, last) + ")";
+}
+
+// Function to display a plan together with its cost against left-to-right multiplication
+void displayMatrixChainPlan(const MatrixChainPlan& plan) {
+    int count = plan.dimensions.size() - 1;
+
+    cout << "Order: " << describeMatrixChainPlan(plan, 0, count - 1) << endl;
+    cout << "Planned cost: " << plan.plannedCost << " multiplications" << endl;
+    cout << "Left-to-right cost: " << plan.naiveCost << " multiplications" << endl;
+}
+
+// Function to multiply matrices first..last following a plan.
+// Each level of the plan holds at most one temporary, so live temporaries are bounded by the plan depth.
+vector<vector<int>> executeMatrixChain(const vector<vector<vector<int>>>& matrices, const MatrixChainPlan& plan, int first, int last) {
+    if (first == last) {
+        return matrices[first];
+    }
+
+    int k = plan.split[first][last];
+
+    if (first == k && k + 1 == last) {
+        return multiplyMatrices(matrices[first], matrices[last]);
+    }
+    if (first == k) {
+        return multiplyMatrices(matrices[first], executeMatrixChain(matrices, plan, k + 1, last));
+    }
+    if (k + 1 == last) {
+        return multiplyMatrices(executeMatrixChain(matrices, plan, first, k), matrices[last]);
+    }
+
+    vector<vector<int>> left = executeMatrixChain(matrices, plan, first, k);
+    return multiplyMatrices(left, executeMatrixChain(matrices, plan, k + 1, last));
+}
+
+// Function to multiply a chain of matrices in the cheapest order
+vector<vector<int>> multiplyMatrixChain(const vector<vector<vector<int>>>& matrices) {
+    MatrixChainPlan plan = planMatrixChain(matrices);
+    return executeMatrixChain(matrices, plan, 0, matrices.size() - 1);
+}
+
+// Function to check that a modulus is usable by the modular matrix functions
+void checkModulus(long long modulus) {
+    if (modulus < 2 || modulus > INT_MAX) {
+        cerr << "Error: Modulus must be between 2 and " << INT_MAX << "." << endl;
+        exit(1);
+    }
+}
+
+// Function to reduce every entry of a matrix into [0, modulus)
+vector<vector<uint32_t>> reduceMatrixModulo(const vector<vector<int>>& matrix, uint32_t modulus) {
+    vector<vector<uint32_t>> result(matrix.size(), vector<uint32_t>(matrix[0].size()));
+
+    for (size_t i = 0; i < matrix.size(); i++) {
+        for (size_t j = 0; j < matrix[i].size(); j++) {
+            long long value = matrix[i][j] % static_cast<long long>(modulus);
+            result[i][j] = static_cast<uint32_t>(value < 0 ? value + modulus : value);
+        }
+    }
+
+    return result;
+}
+
+// Function to multiply two matrices with entries in [0, modulus) into an existing result, modulo modulus.
+// Products are summed in 64 bits and only reduced once the next term could overflow the sum.
+void multiplyReducedMatricesModuloInto(const vector<vector<uint32_t>>& matrix1, const vector<vector<uint32_t>>& matrix2,
+    vector<vector<uint32_t>>& result, uint32_t modulus) {
+    int rows1 = matrix1.size();
+    int cols1 = matrix1[0].size();
+    int rows2 = matrix2.size();
+    int cols2 = matrix2[0].size();
+
+    if (cols1 != rows2) {
+        cerr << "Error: Matrix dimensions are not compatible for multiplication." << endl;
+        exit(1);
+    }
+
+    result.resize(rows1);
+    for (auto& row : result) {
+        row.resize(cols2);
+    }
+
+    uint64_t largestProduct = static_cast<uint64_t>(modulus - 1) * (modulus - 1);
+    int interval = static_cast<int>(min<uint64_t>(cols1, (UINT64_MAX - (modulus - 1)) / max<uint64_t>(largestProduct, 1)));
+    vector<uint64_t> sums(cols2);
+
+    for (int i = 0; i < rows1; i++) {
+        fill(sums.begin(), sums.end(), 0);
+
+        for (int kk = 0; kk < cols1; kk += interval) {
+            int kEnd = min(cols1, kk + interval);
+
+            // Unsigned 32x32->64 multiply-add over contiguous rows, with no reduction inside the block
+            for (int k = kk; k < kEnd; k++) {
+                uint64_t factor = matrix1[i][k];
+                const uint32_t* row = matrix2[k].data();
+
+                for (int j = 0; j < cols2; j++) {
+                    sums[j] += factor * row[j];
+                }
+            }
+
+            for (int j = 0; j < cols2; j++) {
+                sums[j] %= modulus;
+            }
+        }
+
+        for (int j = 0; j < cols2; j++) {
+            result[i][j] = static_cast<uint32_t>(sums[j]);
+        }
+    }
+}
+
+// Function to multiply two matrices modulo modulus, giving entries in [0, modulus)
+vector<vector<int>> multiplyMatricesModulo(const vector<vector<int>>& matrix1, const vector<vector<int>>& matrix2, int modulus) {
+    checkModulus(modulus);
+
+    vector<vector<uint32_t>> product;
+    multiplyReducedMatricesModuloInto(reduceMatrixModulo(matrix1, modulus), reduceMatrixModulo(matrix2, modulus), product, modulus);
+
+    vector<vector<int>> result(product.size(), vector<int>(product[0].size()));
+    for (size_t i = 0; i < product.size(); i++) {
+        for (size_t j = 0; j < product[i].size(); j++) {
+            result[i][j] = static_cast<int>(product[i][j]);
+        }
+    }
+
+    return result;
+}
+
+// Structure to hold the constants for Montgomery arithmetic modulo an odd modulus, with R = 2^32
+struct MontgomeryModulus {
+    uint32_t modulus;
+    uint32_t negativeInverse;   // -modulus^-1 mod R
+    uint32_t rSquared;          // R^2 mod modulus
+};
+
+// Function to prepare Montgomery constants for an odd modulus
+MontgomeryModulus createMontgomeryModulus(int modulus) {
+    checkModulus(modulus);
+
+    if (modulus % 2 == 0) {
+        cerr << "Error: Montgomery form requires an odd modulus." << endl;
+        exit(1);
+    }
+
+    MontgomeryModulus mont;
+    mont.modulus = modulus;
+
+    // Newton iteration doubles the number of correct low bits each step: 1 -> 2 -> 4 -> ... -> 32
+    uint32_t inverse = mont.modulus;
+    for (int step = 0; step < 5; step++) {
+        inverse *= 2 - mont.modulus * inverse;
+    }
+    mont.negativeInverse = 0u - inverse;
+
+    uint64_t r = (uint64_t(1) << 32) % mont.modulus;
+    mont.rSquared = static_cast<uint32_t>(r * r % mont.modulus);
+
+    return mont;
+}
+
+// Function to compute value * R^-1 mod modulus for value < modulus * R
+inline uint32_t montgomeryReduce(uint64_t value, const MontgomeryModulus& mont) {
+    uint32_t m = static_cast<uint32_t>(value) * mont.negativeInverse;
+    uint64_t reduced = (value + static_cast<uint64_t>(m) * mont.modulus) >> 32;
+    return static_cast<uint32_t>(reduced >= mont.modulus ? reduced - mont.modulus : reduced);
+}
+
+// Function to convert a matrix into Montgomery form
+vector<vector<uint32_t>> toMontgomeryMatrix(const vector<vector<int>>& matrix, const MontgomeryModulus& mont) {
+    vector<vector<uint32_t>> result = reduceMatrixModulo(matrix, mont.modulus);
+
+    for (auto& row : result) {
+        for (uint32_t& value : row) {
+            value = montgomeryReduce(static_cast<uint64_t>(value) * mont.rSquared, mont);
+        }
+    }
+
+    return result;
+}
+
+// Function to convert a matrix out of Montgomery form
+vector<vector<int>> fromMontgomeryMatrix(const vector<vector<uint32_t>>& matrix, const MontgomeryModulus& mont) {
+    vector<vector<int>> result(matrix.size(), vector<int>(matrix[0].size()));
+
+    for (size_t i = 0; i < matrix.size(); i++) {
+        for (size_t j = 0; j < matrix[i].size(); j++) {
+            result[i][j] = static_cast<int>(montgomeryReduce(matrix[i][j], mont));
+        }
+    }
+
+    return result;
+}
+
+// Function to multiply two Montgomery-form matrices into an existing result, also in Montgomery form.
+// Blocks of products are summed in 64 bits while the sum stays below modulus * R, then reduced without division.
+void multiplyMontgomeryMatricesInto(const vector<vector<uint32_t>>& matrix1, const vector<vector<uint32_t>>& matrix2,
+    vector<vector<uint32_t>>& result, const MontgomeryModulus& mont) {
+    int rows1 = matrix1.size();
+    int cols1 = matrix1[0].size();
+    int rows2 = matrix2.size();
+    int cols2 = matrix2[0].size();
+
+    if (cols1 != rows2) {
+        cerr << "Error: Matrix dimensions are not compatible for multiplication." << endl;
+        exit(1);
+    }
+
+    result.resize(rows1);
+    for (auto& row : result) {
+        row.resize(cols2);
+    }
+
+    uint64_t limit = (static_cast<uint64_t>(mont.modulus) << 32) - 1;
+    uint64_t largestProduct = static_cast<uint64_t>(mont.modulus - 1) * (mont.modulus - 1);
+    int interval = static_cast<int>(min<uint64_t>(cols1, limit / max<uint64_t>(largestProduct, 1)));
+    vector<uint64_t> sums(cols2);
+
+    for (int i = 0; i < rows1; i++) {
+        uint32_t* output = result[i].data();
+        fill(output, output + cols2, 0u);
+
+        for (int kk = 0; kk < cols1; kk += interval) {
+            int kEnd = min(cols1, kk + interval);
+            fill(sums.begin(), sums.end(), 0);
+
+            for (int k = kk; k < kEnd; k++) {
+                uint64_t factor = matrix1[i][k];
+                const uint32_t* row = matrix2[k].data();
+
+                for (int j = 0; j < cols2; j++) {
+                    sums[j] += factor * row[j];
+                }
+            }
+
+            for (int j = 0; j < cols2; j++) {
+                uint32_t sum = output[j] + montgomeryReduce(sums[j], mont);
+                output[j] = sum >= mont.modulus ? sum - mont.modulus : sum;
+            }
+        }
+    }
+}
+
+// Function to raise a square matrix to a non-negative power modulo modulus by repeated squaring
+vector<vector<int>> powerMatrixModulo(const vector<vector<int>>& matrix, unsigned long long exponent, int modulus) {
+    int size = matrix.size();
+
+    if (size == 0 || static_cast<int>(matrix[0].size()) != size) {
+        cerr << "Error: Matrix power requires a square matrix." << endl;
+        exit(1);
+    }
+
+    checkModulus(modulus);
+
+    vector<vector<int>> identity = generateIdentityMatrix(size);
+    vector<vector<uint32_t>> scratch(size, vector<uint32_t>(size));
+
+    if (modulus % 2 == 1) {
+        MontgomeryModulus mont = createMontgomeryModulus(modulus);
+        vector<vector<uint32_t>> result = toMontgomeryMatrix(identity, mont);
+        vector<vector<uint32_t>> base = toMontgomeryMatrix(matrix, mont);
+
+        while (exponent > 0) {
+            if (exponent & 1) {
+                multiplyMontgomeryMatricesInto(result, base, scratch, mont);
+                swap(result, scratch);
+            }
+
+            exponent >>= 1;
+
+            if (exponent > 0) {
+                multiplyMontgomeryMatricesInto(base, base, scratch, mont);
+                swap(base, scratch);
+            }
+        }
+
+        return fromMontgomeryMatrix(result, mont);
+    }
+
+    vector<vector<uint32_t>> result = reduceMatrixModulo(identity, modulus);
+    vector<vector<uint32_t>> base = reduceMatrixModulo(matrix, modulus);
+
+    while (exponent > 0) {
+        if (exponent & 1) {
+            multiplyReducedMatricesModuloInto(result, base, scratch, modulus);
+            swap(result, scratch);
+        }
+
+        exponent >>= 1;
+
+        if (exponent > 0) {
+            multiplyReducedMatricesModuloInto(base, base, scratch, modulus);
+            swap(base, scratch);
+        }
+    }
+
+    vector<vector<int>> reduced(size, vector<int>(size));
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            reduced[i][j] = static_cast<int>(result[i][j]);
+        }
+    }
+
+    return reduced;
+}
+
+// Structure to represent a sparse matrix in compressed sparse row (CSR) form
+struct CSRMatrix {
+    int rows = 0;
+    int cols = 0;
+    vector<int> rowOffsets;   // rows + 1 entries; row i occupies [rowOffsets[i], rowOffsets[i + 1])
+    vector<int> colIndices;
+    vector<int> values;
+};
+
+// Structure to represent a sparse matrix in compressed sparse column (CSC) form
+struct CSCMatrix {
+    int rows = 0;
+    int cols = 0;
+    vector<int> colOffsets;   // cols + 1 entries; column j occupies [colOffsets[j], colOffsets[j + 1])
+    vector<int> rowIndices;
+    vector<int> values;
+};
+
+// Number of sparse rows worth handing to one thread
+const size_t SPARSE_ROW_GRAIN = 256;
+
+// Function to convert a dense matrix to CSR form
+CSRMatrix denseToCSR(const vector<vector<int>>& matrix) {
+    CSRMatrix sparse;
+    sparse.rows = matrix.size();
+    sparse.cols = matrix[0].size();
+    sparse.rowOffsets.reserve(sparse.rows + 1);
+    sparse.rowOffsets.push_back(0);
+
+    for (int i = 0; i < sparse.rows; i++) {
+        for (int j = 0; j < sparse.cols; j++) {
+            if (matrix[i][j] != 0) {
+                sparse.colIndices.push_back(j);
+                sparse.values.push_back(matrix[i][j]);
+            }
+        }
+        sparse.rowOffsets.push_back(sparse.colIndices.size());
+    }
+
+    return sparse;
+}
+
+// Function to read a rows x cols matrix written densely as text directly into CSR form
+CSRMatrix readCSRMatrix(istream& input, int rows, int cols) {
+    CSRMatrix sparse;
+    sparse.rows = rows;
+    sparse.cols = cols;
+    sparse.rowOffsets.reserve(rows + 1);
+    sparse.rowOffsets.push_back(0);
+
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            int element;
+            if (!(input >> element)) {
+                cerr << "Error: Not enough matrix elements in the input." << endl;
+                exit(1);
+            }
+            if (element != 0) {
+                sparse.colIndices.push_back(j);
+                sparse.values.push_back(element);
+            }
+        }
+        sparse.rowOffsets.push_back(sparse.colIndices.size());
+    }
+
+    return sparse;
+}
+
+// Function to convert a CSR matrix back to a dense matrix
+vector<vector<int>> sparseToDense(const CSRMatrix& sparse) {
+    vector<vector<int>> matrix(sparse.rows, vector<int>(sparse.cols));
+
+    for (int i = 0; i < sparse.rows; i++) {
+        for (int p = sparse.rowOffsets[i]; p < sparse.rowOffsets[i + 1]; p++) {
+            matrix[i][sparse.colIndices[p]] = sparse.values[p];
+        }
+    }
+
+    return matrix;
+}
+
+// Function to transpose a CSR matrix with a counting sort over column indices
+CSRMatrix transposeSparse(const CSRMatrix& sparse) {
+    CSRMatrix result;
+    result.rows = sparse.cols;
+    result.cols = sparse.rows;
+    result.rowOffsets.assign(result.rows + 1, 0);
+    result.colIndices.resize(sparse.values.size());
+    result.values.resize(sparse.values.size());
+
+    for (int col : sparse.colIndices) {
+        result.rowOffsets[col + 1]++;
+    }
+
+    for (int j = 0; j < result.rows; j++) {
+        result.rowOffsets[j + 1] += result.rowOffsets[j];
+    }
+
+    // Rows are visited in order, so each output row comes out with sorted column indices
+    vector<int> next(result.rowOffsets.begin(), result.rowOffsets.end() - 1);
+
+    for (int i = 0; i < sparse.rows; i++) {
+        for (int p = sparse.rowOffsets[i]; p < sparse.rowOffsets[i + 1]; p++) {
+            int destination = next[sparse.colIndices[p]]++;
+            result.colIndices[destination] = i;
+            result.values[destination] = sparse.values[p];
+        }
+    }
+
+    return result;
+}
+
+// Function to convert a CSR matrix to CSC form
+CSCMatrix csrToCSC(const CSRMatrix& sparse) {
+    // The CSR arrays of the transpose are exactly the CSC arrays of the original
+    CSRMatrix transposed = transposeSparse(sparse);
+
+    CSCMatrix result;
+    result.rows = sparse.rows;
+    result.cols = sparse.cols;
+    result.colOffsets = move(transposed.rowOffsets);
+    result.rowIndices = move(transposed.colIndices);
+    result.values = move(transposed.values);
+
+    return result;
+}
+
+// Function to convert a dense matrix to CSC form
+CSCMatrix denseToCSC(const vector<vector<int>>& matrix) {
+    return csrToCSC(denseToCSR(matrix));
+}
+
+// Function to multiply a CSR matrix by a dense vector
+vector<int> multiplySparseMatrixVector(const CSRMatrix& sparse, const vector<int>& vec) {
+    if (static_cast<int>(vec.size()) != sparse.cols) {
+        cerr << "Error: Matrix and vector dimensions are not compatible for multiplication." << endl;
+        exit(1);
+    }
+
+    vector<int> result(sparse.rows);
+    vector<char> overflows(ParallelCore::chooseThreadCount(sparse.rows, SPARSE_ROW_GRAIN));
+
+    // Row ranges fit in int, so the body takes them as int like the rest of the sparse code
+    ParallelCore::runInParallel(sparse.rows, overflows.size(), [&](int t, int begin, int end) {
+        bool overflow = false;
+
+        for (int i = begin; i < end; i++) {
+            long long sum = 0;
+            int wraps = 0;
+            for (int p = sparse.rowOffsets[i]; p < sparse.rowOffsets[i + 1]; p++) {
+                wraps += addWrapping(sum, static_cast<long long>(sparse.values[p]) * vec[sparse.colIndices[p]]);
+            }
+            overflow |= wraps != 0;
+            result[i] = CheckedPolicy::narrow(sum, overflow);
+        }
+
+        overflows[t] = overflow;
+    });
+
+    if (find(overflows.begin(), overflows.end(), 1) != overflows.end()) {
+        cerr << "Error: Matrix-vector product overflows the integer range." << endl;
+        exit(1);
+    }
+
+    return result;
+}
+
+// Function to multiply two CSR matrices using Gustavson's row-by-row algorithm
+CSRMatrix multiplySparseMatrices(const CSRMatrix& matrix1, const CSRMatrix& matrix2) {
+    if (matrix1.cols != matrix2.rows) {
+        cerr << "Error: Matrix dimensions are not compatible for multiplication." << endl;
+        exit(1);
+    }
+
+    int threadCount = ParallelCore::chooseThreadCount(matrix1.rows, SPARSE_ROW_GRAIN);
+
+    // Each thread produces its block of rows into its own arrays, which are stitched together afterwards
+    vector<vector<int>> blockOffsets(threadCount);
+    vector<vector<int>> blockIndices(threadCount);
+    vector<vector<int>> blockValues(threadCount);
+    vector<int> blockBegins(threadCount);
+    vector<char> overflows(threadCount);
+
+    ParallelCore::runInParallel(matrix1.rows, threadCount, [&](int t, int begin, int end) {
+        // Dense accumulator indexed by output column, with a marker recording which row last touched it
+        vector<long long> sums(matrix2.cols);
+        vector<int> wraps(matrix2.cols);
+        vector<int> marker(matrix2.cols, -1);
+        vector<int> touched;
+        bool overflow = false;
+
+        blockBegins[t] = begin;
+        blockOffsets[t].push_back(0);
+
+        for (int i = begin; i < end; i++) {
+            touched.clear();
+
+            for (int p = matrix1.rowOffsets[i]; p < matrix1.rowOffsets[i + 1]; p++) {
+                long long factor = matrix1.values[p];
+                int k = matrix1.colIndices[p];
+
+                for (int q = matrix2.rowOffsets[k]; q < matrix2.rowOffsets[k + 1]; q++) {
+                    int j = matrix2.colIndices[q];
+                    if (marker[j] != i) {
+                        marker[j] = i;
+                        sums[j] = 0;
+                        wraps[j] = 0;
+                        touched.push_back(j);
+                    }
+                    wraps[j] += addWrapping(sums[j], factor * matrix2.values[q]);
+                }
+            }
+
+            sort(touched.begin(), touched.end());
+
+            for (int j : touched) {
+                // A sum that wrapped is outside the long long range even if it wrapped back to 0
+                overflow |= wraps[j] != 0;
+
+                if (sums[j] != 0) {
+                    blockIndices[t].push_back(j);
+                    blockValues[t].push_back(CheckedPolicy::narrow(sums[j], overflow));
+                }
+            }
+
+            blockOffsets[t].push_back(blockIndices[t].size());
+        }
+
+        overflows[t] = overflow;
+    });
+
+    if (find(overflows.begin(), overflows.end(), 1) != overflows.end()) {
+        cerr << "Error: Matrix product overflows the integer range." << endl;
+        exit(1);
+    }
+
+    CSRMatrix result;
+    result.rows = matrix1.rows;
+    result.cols = matrix2.cols;
+    result.rowOffsets.assign(result.rows + 1, 0);
+
+    size_t nonZeros = 0;
+    for (int t = 0; t < threadCount; t++) {
+        nonZeros += blockIndices[t].size();
+    }
+    result.colIndices.reserve(nonZeros);
+    result.values.reserve(nonZeros);
+
+    for (int t = 0; t < threadCount; t++) {
+        int base = result.colIndices.size();
+        for (size_t r = 1; r < blockOffsets[t].size(); r++) {
+            result.rowOffsets[blockBegins[t] + r] = base + blockOffsets[t][r];
+        }
+        result.colIndices.insert(result.colIndices.end(), blockIndices[t].begin(), blockIndices[t].end());
+        result.values.insert(result.values.end(), blockValues[t].begin(), blockValues[t].end());
+    }
+
+    return result;
+}
+
+// Operations the streaming mode can evaluate for each record, combined as a bit mask
+enum StreamOperation {
+    STREAM_DETERMINANT = 1 << 0,
+    STREAM_TRANSPOSE = 1 << 1,
+    STREAM_INVERSE = 1 << 2,
+    STREAM_SCALAR = 1 << 3,
+    STREAM_ADD = 1 << 4,
+    STREAM_SUBTRACT = 1 << 5,
+    STREAM_PRODUCT_AB = 1 << 6,
+    STREAM_PRODUCT_BA = 1 << 7,
+    STREAM_IDENTITY = 1 << 8,
+    STREAM_ALL = (1 << 9) - 1
+};
+
+// Number of integers in one streaming record: a 4x4 A, a 4x4 B and a scalar
+const int STREAM_RECORD_SIZE = 33;
+
+// Size of each of the two input buffers used by the streaming reader
+const size_t STREAM_CHUNK_SIZE = 1 << 20;
+
+// Function to parse a comma-separated list of operation names into a StreamOperation mask
+int parseStreamOperations(const string& list) {
+    static const pair<const char*, int> names[] = {
+        { "det", STREAM_DETERMINANT }, { "transpose", STREAM_TRANSPOSE }, { "inverse", STREAM_INVERSE },
+        { "scalar", STREAM_SCALAR }, { "add", STREAM_ADD }, { "subtract", STREAM_SUBTRACT },
+        { "ab", STREAM_PRODUCT_AB }, { "ba", STREAM_PRODUCT_BA }, { "identity", STREAM_IDENTITY },
+        { "all", STREAM_ALL }
+    };
+
+    int mask = 0;
+    size_t start = 0;
+
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == string::npos) {
+            end = list.size();
+        }
+
+        string name = list.substr(start, end - start);
+        bool known = false;
+
+        for (const auto& entry : names) {
+            if (name == entry.first) {
+                mask |= entry.second;
+                known = true;
+            }
+        }
+
+        if (!known) {
+            cerr << "Error: Unknown operation '" << name << "'." << endl;
+            exit(1);
+        }
+
+        start = end + 1;
+    }
+
+    return mask;
+}
+
+// Structure to read an input stream on a background thread into two alternating buffers
+struct DoubleBufferedReader {
+    istream& input;
+    vector<char> buffers[2];
+    size_t sizes[2] = { 0, 0 };
+    bool ready[2] = { false, false };
+    mutex lock;
+    condition_variable changed;
+    thread worker;
+
+    explicit DoubleBufferedReader(istream& in)
+        : input(in) {
+        buffers[0].resize(STREAM_CHUNK_SIZE);
+        buffers[1].resize(STREAM_CHUNK_SIZE);
+        worker = thread([this] { fill(); });
+    }
+
+    ~DoubleBufferedReader() {
+        worker.join();
+    }
+
+    // Reader thread: fill whichever buffer the consumer has released; an empty buffer marks the end
+    void fill() {
+        for (int slot = 0;; slot ^= 1) {
+            {
+                unique_lock<mutex> guard(lock);
+                changed.wait(guard, [&] { return !ready[slot]; });
+            }
+
+            input.read(buffers[slot].data(), buffers[slot].size());
+            size_t count = static_cast<size_t>(input.gcount());
+
+            {
+                lock_guard<mutex> guard(lock);
+                sizes[slot] = count;
+                ready[slot] = true;
+            }
+            changed.notify_all();
+
+            if (count == 0) {
+                return;
+            }
+        }
+    }
+
+    // Consumer: wait for a filled buffer and return its size
+    size_t acquire(int slot) {
+        unique_lock<mutex> guard(lock);
+        changed.wait(guard, [&] { return ready[slot]; });
+        return sizes[slot];
+    }
+
+    // Consumer: hand a buffer back to the reader thread
+    void release(int slot) {
+        {
+            lock_guard<mutex> guard(lock);
+            ready[slot] = false;
+        }
+        changed.notify_all();
+    }
+};
+
+// Structure to format output text into a fixed buffer that is written out only when full
+struct BufferedWriter {
+    ostream& output;
+    vector<char> buffer;
+    size_t used = 0;
+
+    explicit BufferedWriter(ostream& out)
+        : output(out), buffer(STREAM_CHUNK_SIZE) {}
+
+    ~BufferedWriter() {
+        flush();
+    }
+
+    void flush() {
+        output.write(buffer.data(), used);
+        used = 0;
+    }
+
+    // Make room for at least count more characters
+    void reserve(size_t count) {
+        if (used + count > buffer.size()) {
+            flush();
+        }
+    }
+
+    void writeText(const char* text) {
+        size_t length = char_traits<char>::length(text);
+        reserve(length);
+        copy(text, text + length, buffer.data() + used);
+        used += length;
+    }
+
+    void writeChar(char c) {
+        reserve(1);
+        buffer[used++] = c;
+    }
+
+    void writeInteger(long long value) {
+        char digits[24];
+        int count = 0;
+        unsigned long long magnitude = value < 0 ? 0ull - static_cast<unsigned long long>(value) : value;
+
+        do {
+            digits[count++] = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude > 0);
+
+        reserve(count + 1);
+        if (value < 0) {
+            buffer[used++] = '-';
+        }
+        while (count > 0) {
+            buffer[used++] = digits[--count];
+        }
+    }
+
+    // Write a label followed by the 16 entries of a 4x4 matrix on one line
+    void writeMatrix(const char* label, const int* matrix) {
+        writeText(label);
+        for (int i = 0; i < 16; i++) {
+            writeChar(' ');
+            writeInteger(matrix[i]);
+        }
+        writeChar('\n');
+    }
+};
+
+// Function to multiply two row-major 4x4 matrices, returning false if an entry overflows an int
+bool multiply4x4(const int* matrix1, const int* matrix2, int* result) {
+    long long sums[16];
+    bool overflow = false;
+
+    if (accumulatorCannotOverflow<long long>(4, largestMagnitude(matrix1, 16), largestMagnitude(matrix2, 16))) {
+        MatrixCore::multiplySmall<4, long long>(matrix1, matrix2, sums);
+    } else {
+        // Entries large enough to overflow the 64-bit sums; any sum that wraps is outside the int range
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                long long sum = 0;
+                int wraps = 0;
+                for (int k = 0; k < 4; k++) {
+                    wraps += addWrapping(sum, static_cast<long long>(matrix1[i * 4 + k]) * matrix2[k * 4 + j]);
+                }
+                overflow |= wraps != 0;
+                sums[i * 4 + j] = sum;
+            }
+        }
+    }
+
+    for (int i = 0; i < 16; i++) {
+        result[i] = CheckedPolicy::narrow(sums[i], overflow);
+    }
+
+    return !overflow;
+}
+
+// Function to write a 4x4 result computed in 64 bits, or "<label> overflow" if an entry is outside the int range
+void writeCheckedMatrix(BufferedWriter& writer, const char* label, const long long* sums) {
+    int result[16];
+    bool overflow = false;
+
+    for (int i = 0; i < 16; i++) {
+        result[i] = CheckedPolicy::narrow(sums[i], overflow);
+    }
+
+    if (overflow) {
+        writer.writeText(label);
+        writer.writeText(" overflow\n");
+    }
+    else {
+        writer.writeMatrix(label, result);
+    }
+}
+
+// Function to evaluate the selected operations on one record and format the results.
+// Matches the single-record mode, except that failures are reported per record instead of stopping.
+// Every result is computed in 64 bits, where no operation on int entries can overflow, and narrowed with a check.
+void evaluateStreamRecord(const int* record, int operations, BufferedWriter& writer) {
+    const int* a = record;
+    const int* b = record + 16;
+    long long scalar = record[32];
+    int result[16];
+    long long sums[16];
+
+    long long determinant = static_cast<long long>(a[0]) * a[5] - static_cast<long long>(a[1]) * a[4];
+
+    if (operations & STREAM_DETERMINANT) {
+        bool overflow = false;
+        int narrowed = CheckedPolicy::narrow(determinant, overflow);
+
+        if (overflow) {
+            writer.writeText("|A|: overflow\n");
+        }
+        else {
+            writer.writeText("|A|: ");
+            writer.writeInteger(narrowed);
+            writer.writeChar('\n');
+        }
+    }
+
+    if (operations & STREAM_TRANSPOSE) {
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                result[j * 4 + i] = a[i * 4 + j];
+            }
+        }
+        writer.writeMatrix("AT:", result);
+    }
+
+    if (operations & STREAM_INVERSE) {
+        if (determinant == 0) {
+            writer.writeText("A-1: not invertible\n");
+        }
+        else {
+            fill(sums, sums + 16, 0);
+            sums[0] = a[5] / determinant;
+            sums[1] = -static_cast<long long>(a[1]) / determinant;
+            sums[4] = -static_cast<long long>(a[4]) / determinant;
+            sums[5] = a[0] / determinant;
+            writeCheckedMatrix(writer, "A-1:", sums);
+        }
+    }
+
+    if (operations & STREAM_SCALAR) {
+        for (int i = 0; i < 16; i++) {
+            sums[i] = a[i] * scalar;
+        }
+        writeCheckedMatrix(writer, "tA:", sums);
+    }
+
+    if (operations & STREAM_ADD) {
+        for (int i = 0; i < 16; i++) {
+            sums[i] = static_cast<long long>(a[i]) + b[i];
+        }
+        writeCheckedMatrix(writer, "A + B:", sums);
+    }
+
+    if (operations & STREAM_SUBTRACT) {
+        for (int i = 0; i < 16; i++) {
+            sums[i] = static_cast<long long>(a[i]) - b[i];
+        }
+        writeCheckedMatrix(writer, "A - B:", sums);
+    }
+
+    if (operations & STREAM_PRODUCT_AB) {
+        if (multiply4x4(a, b, result)) {
+            writer.writeMatrix("A * B:", result);
+        }
+        else {
+            writer.writeText("A * B: overflow\n");
+        }
+    }
+
+    if (operations & STREAM_PRODUCT_BA) {
+        if (multiply4x4(b, a, result)) {
+            writer.writeMatrix("B * A:", result);
+        }
+        else {
+            writer.writeText("B * A: overflow\n");
+        }
+    }
+
+    if (operations & STREAM_IDENTITY) {
+        writer.writeText("I: 1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1\n");
+    }
+}
+
+// Function to stream records of (A, B, scalar) from input to output, returning the number of records processed.
+// Integers are tokenized straight out of the reader's buffers, so numbers may span buffer boundaries.
+// A number is an optional sign followed by digits, and numbers are separated by whitespace; anything else, or
+// a number outside the int range, stops the stream with an error.
+long long runStream(istream& input, ostream& output, int operations) {
+    DoubleBufferedReader reader(input);
+    BufferedWriter writer(output);
+
+    int record[STREAM_RECORD_SIZE];
+    int filled = 0;
+    long long records = 0;
+
+    bool inNumber = false;
+    bool hasSign = false;
+    bool negative = false;
+    long long value = 0;
+
+    // Store the finished number, evaluating the record once it is complete
+    auto finishNumber = [&] {
+        if (hasSign && !inNumber) {
+            cerr << "Error: A sign in the input stream is not followed by digits." << endl;
+            exit(1);
+        }
+
+        if (inNumber) {
+            record[filled++] = static_cast<int>(negative ? -value : value);
+            if (filled == STREAM_RECORD_SIZE) {
+                evaluateStreamRecord(record, operations, writer);
+                filled = 0;
+                records++;
+            }
+        }
+
+        inNumber = false;
+        hasSign = false;
+        negative = false;
+        value = 0;
+    };
+
+    for (int slot = 0;; slot ^= 1) {
+        size_t size = reader.acquire(slot);
+        const char* data = reader.buffers[slot].data();
+
+        for (size_t p = 0; p < size; p++) {
+            char c = data[p];
+
+            if (c >= '0' && c <= '9') {
+                value = value * 10 + (c - '0');
+                inNumber = true;
+
+                // Checking every digit keeps value within 11 digits, so it cannot overflow however long the number is
+                if (value > (negative ? -static_cast<long long>(INT_MIN) : static_cast<long long>(INT_MAX))) {
+                    cerr << "Error: A number in the input stream is outside the integer range." << endl;
+                    exit(1);
+                }
+            } else if (c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f') {
+                finishNumber();
+            } else if ((c == '-' || c == '+') && !inNumber && !hasSign) {
+                hasSign = true;
+                negative = (c == '-');
+            } else {
+                cerr << "Error: Unexpected character '" << c << "' in the input stream; only integers separated by whitespace are accepted." << endl;
+                exit(1);
+            }
+        }
+
+        reader.release(slot);
+
+        if (size == 0) {
+            break;
+        }
+    }
+
+    // The last number may end at the end of the input rather than at whitespace
+    finishNumber();
+
+    if (filled != 0) {
+        cerr << "Warning: Ignoring an incomplete record at the end of the input." << endl;
+    }
+
+    return records;
+}
+
+// Function to run the streaming mode: MatrixCal --stream <input|-> [output|-] [operations]
+int runStreamMode(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: MatrixCal --stream <input|-> [output|-] [det,transpose,inverse,scalar,add,subtract,ab,ba,identity|all]" << endl;
+        return 1;
+    }
+
+    ios::sync_with_stdio(false);
+
+    string inputName = argv[2];
+    string outputName = argc > 3 ? argv[3] : "-";
+    int operations = argc > 4 ? parseStreamOperations(argv[4]) : STREAM_ALL;
+
+    ifstream inputFile;
+    ofstream outputFile;
+
+    if (inputName != "-") {
+        inputFile.open(inputName, ios::binary);
+        if (!inputFile) {
+            cerr << "Error: Failed to open the input file." << endl;
+            return 1;
+        }
+    }
+
+    if (outputName != "-") {
+        outputFile.open(outputName, ios::binary);
+        if (!outputFile) {
+            cerr << "Error: Failed to open the output file." << endl;
+            return 1;
+        }
+    }
+
+    istream& input = inputName != "-" ? static_cast<istream&>(inputFile) : cin;
+    ostream& output = outputName != "-" ? static_cast<ostream&>(outputFile) : cout;
+
+    auto start = chrono::steady_clock::now();
+    long long records = runStream(input, output, operations);
+    output.flush();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cerr << "Processed " << records << " records in " << seconds << " s ("
+        << (seconds > 0 ? records / seconds : 0.0) << " records/sec)" << endl;
+
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--stream") {
+        return runStreamMode(argc, argv);
+    }
+
+    string accumulation = argc > 1 ? argv[1] : "";
+
+    if (argc > 2 || (argc > 1 && accumulation != "--wide" && accumulation != "--saturate")) {
+        cerr << "Usage: MatrixCal [--wide|--saturate]" << endl;
+        cerr << "       MatrixCal --stream <input|-> [output|-] [operations]" << endl;
+        return 1;
+    }
+
     ifstream inputFile("Matrix.txt");
 
     if (!inputFile) {
@@ -214,12 +2320,10 @@ int main() {
     displayMatrix(subtractionAB);
 
     cout << "A * B:" << endl;
-    vector<vector<int>> multiplicationAB = multiplyMatrices(matrixA, matrixB);
-    displayMatrix(multiplicationAB);
+    displayProduct(matrixA, matrixB, accumulation);
 
     cout << "B * A:" << endl;
-    vector<vector<int>> multiplicationBA = multiplyMatrices(matrixB, matrixA);
-    displayMatrix(multiplicationBA);
+    displayProduct(matrixB, matrixA, accumulation);
 
     cout << "Identity Matrix:" << endl;
     vector<vector<int>> identityMatrix = generateIdentityMatrix(4);
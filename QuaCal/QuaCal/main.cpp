@@ -1,65 +1,177 @@
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <vector>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <functional>
+#include <thread>
+#include <charconv>
+#include <limits>
+#if defined(__AVX__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include "../../Common/MatrixCore.h"
+#include "../../Common/QuaternionCore.h"
+#include "../../Common/ParallelCore.h"
 
 using namespace std;
 
-// Structure to represent a quaternion
-struct Quaternion {
-    double scalar;
-    double i;
-    double j;
-    double k;
+// The calculator works in double precision; the batched kernels below depend on it
+typedef QuaternionCore::Quaternion<double> Quaternion;
 
-    Quaternion(double s = 0.0, double i = 0.0, double j = 0.0, double k = 0.0)
-        : scalar(s), i(i), j(j), k(k) {}
-};
+// Function to skip spaces, tabs and the carriage return of a Windows line ending
+inline const char* skipSpaces(const char* first, const char* last) {
+    while (first != last && (*first == ' ' || *first == '\t' || *first == '\r')) {
+        first++;
+    }
+    return first;
+}
+
+// Function to parse a quaternion written as a sum of terms such as "1 + 2i + 3j + 4k" without allocating.
+// Terms may come in any order or be left out (missing components are zero), a unit term may leave out
+// its coefficient ("2 - i" is 2 - 1i), and every term after the first starts with + or -.
+// Returns false if the text is not of this form or gives a component twice.
+bool parseQuaternion(const char* first, const char* last, Quaternion& quaternion) {
+    quaternion = Quaternion();
+    double* components[4] = { &quaternion.scalar, &quaternion.i, &quaternion.j, &quaternion.k };
+    bool seen[4] = {};
+    bool firstTerm = true;
+
+    first = skipSpaces(first, last);
+
+    if (first == last) {
+        return false;
+    }
+
+    while (first != last) {
+        double sign = 1.0;
+
+        if (*first == '+' || *first == '-') {
+            sign = *first == '-' ? -1.0 : 1.0;
+            first = skipSpaces(first + 1, last);
+        } else if (!firstTerm) {
+            return false;
+        }
+
+        double coefficient = 1.0;
+        bool hasCoefficient = false;
+
+        if (first != last && *first != 'i' && *first != 'j' && *first != 'k') {
+            from_chars_result result = from_chars(first, last, coefficient);
+
+            if (result.ec != errc()) {
+                return false;
+            }
+
+            first = skipSpaces(result.ptr, last);
+            hasCoefficient = true;
+        }
+
+        int component = 0;
 
-// Function to parse a quaternion from a string
+        if (first != last && (*first == 'i' || *first == 'j' || *first == 'k')) {
+            component = *first - 'i' + 1;
+            first++;
+        } else if (!hasCoefficient) {
+            return false;
+        }
+
+        if (seen[component]) {
+            return false;
+        }
+
+        seen[component] = true;
+        *components[component] = sign * coefficient;
+
+        first = skipSpaces(first, last);
+        firstTerm = false;
+    }
+
+    return true;
+}
+
+// Function to parse a quaternion from a string, exiting if it is malformed
 Quaternion parseQuaternion(const string& str) {
-    stringstream ss(str);
     Quaternion quaternion;
 
-    char skipChar;
-    ss >> quaternion.scalar >> skipChar >> quaternion.i >> skipChar >> quaternion.j >> skipChar >> quaternion.k;
+    if (!parseQuaternion(str.data(), str.data() + str.size(), quaternion)) {
+        cerr << "Error: Failed to parse quaternion \"" << str << "\"." << endl;
+        exit(1);
+    }
 
     return quaternion;
 }
 
-// Function to display a quaternion
-void displayQuaternion(const Quaternion& quaternion) {
-    cout << quaternion.scalar << " + " << quaternion.i << "i + " << quaternion.j << "j + " << quaternion.k << "k" << endl;
-}
+// Room for the longest text formatQuaternion writes: four numbers of at most 13 characters
+// ("-1.23457e+308") and the separators between them
+const size_t QUATERNION_TEXT_SIZE = 64;
 
-// Function to add two quaternions
-Quaternion addQuaternions(const Quaternion& a, const Quaternion& b) {
-    return Quaternion(a.scalar + b.scalar, a.i + b.i, a.j + b.j, a.k + b.k);
-}
+// Function to write a quaternion as "a + bi + cj + dk" into [first, last) without allocating, with the
+// 6 significant digits cout uses by default. Returns the end of the text, or nullptr if it does not fit.
+char* formatQuaternion(char* first, char* last, const Quaternion& quaternion) {
+    static const char* const separators[4] = { " + ", "i + ", "j + ", "k" };
+    const double components[4] = { quaternion.scalar, quaternion.i, quaternion.j, quaternion.k };
 
-// Function to subtract two quaternions
-Quaternion subtractQuaternions(const Quaternion& a, const Quaternion& b) {
-    return Quaternion(a.scalar - b.scalar, a.i - b.i, a.j - b.j, a.k - b.k);
-}
+    for (int c = 0; c < 4; c++) {
+        to_chars_result result = to_chars(first, last, components[c], chars_format::general, 6);
 
-// Function to multiply two quaternions
-Quaternion multiplyQuaternions(const Quaternion& a, const Quaternion& b) {
-    double scalar = a.scalar * b.scalar - a.i * b.i - a.j * b.j - a.k * b.k;
-    double i = a.scalar * b.i + a.i * b.scalar + a.j * b.k - a.k * b.j;
-    double j = a.scalar * b.j - a.i * b.k + a.j * b.scalar + a.k * b.i;
-    double k = a.scalar * b.k + a.i * b.j - a.j * b.i + a.k * b.scalar;
+        if (result.ec != errc()) {
+            return nullptr;
+        }
 
-    return Quaternion(scalar, i, j, k);
-}
+        size_t length = char_traits<char>::length(separators[c]);
+
+        if (static_cast<size_t>(last - result.ptr) < length) {
+            return nullptr;
+        }
 
-// Function to calculate the dot product of two quaternions
-double calculateDotProduct(const Quaternion& a, const Quaternion& b) {
-    return a.scalar * b.scalar + a.i * b.i + a.j * b.j + a.k * b.k;
+        first = copy(separators[c], separators[c] + length, result.ptr);
+    }
+
+    return first;
 }
 
-// Function to calculate the conjugate of a quaternion
-Quaternion calculateConjugate(const Quaternion& quaternion) {
-    return Quaternion(quaternion.scalar, -quaternion.i, -quaternion.j, -quaternion.k);
+// Structure to format quaternions, one per line, into a fixed buffer that is written out only when full
+struct QuaternionWriter {
+    ostream& output;
+    vector<char> buffer;
+    size_t used = 0;
+
+    explicit QuaternionWriter(ostream& out, size_t capacity = 65536)
+        : output(out), buffer(max(capacity, QUATERNION_TEXT_SIZE + 1)) {}
+
+    ~QuaternionWriter() {
+        flush();
+    }
+
+    void flush() {
+        output.write(buffer.data(), used);
+        used = 0;
+    }
+
+    void write(const Quaternion& quaternion) {
+        if (buffer.size() - used < QUATERNION_TEXT_SIZE + 1) {
+            flush();
+        }
+
+        char* end = formatQuaternion(buffer.data() + used, buffer.data() + buffer.size(), quaternion);
+        *end++ = '\n';
+        used = end - buffer.data();
+    }
+};
+
+// Function to display a quaternion
+void displayQuaternion(const Quaternion& quaternion) {
+    char text[QUATERNION_TEXT_SIZE + 1];
+    char* end = formatQuaternion(text, text + QUATERNION_TEXT_SIZE, quaternion);
+    *end++ = '\n';
+    cout.write(text, end - text);
 }
 
 // Function to calculate the inverse of a quaternion
@@ -73,12 +185,12 @@ Quaternion calculateInverse(const Quaternion& quaternion) {
     }
 
     double factor = 1.0 / normSquared;
-    return calculateConjugate(quaternion) * factor;
+    return multiplyByScalar(calculateConjugate(quaternion), factor);
 }
 
-// Function to multiply a quaternion by a scalar value
-Quaternion multiplyByScalar(const Quaternion& quaternion, double scalar) {
-    return Quaternion(quaternion.scalar * scalar, quaternion.i * scalar, quaternion.j * scalar, quaternion.k * scalar);
+// Function to calculate the inverse of a quaternion known to have unit length, which is its conjugate
+Quaternion calculateUnitInverse(const Quaternion& quaternion) {
+    return calculateConjugate(quaternion);
 }
 
 // Function to multiply a quaternion by a scalar value from the right
@@ -91,7 +203,2104 @@ Quaternion multiplyScalarFromLeft(double scalar, const Quaternion& quaternion) {
     return multiplyByScalar(quaternion, scalar);
 }
 
-int main() {
+// Structure to hold many quaternions as four separate component arrays (structure of arrays).
+// Each array starts on a 64-byte boundary so vector loads never split a cache line.
+struct QuaternionArray {
+    size_t count = 0;
+    double* scalar = nullptr;
+    double* i = nullptr;
+    double* j = nullptr;
+    double* k = nullptr;
+    vector<double> storage;
+
+    QuaternionArray() {}
+
+    explicit QuaternionArray(size_t n)
+        : count(n) {
+        // Round each component up to a whole number of cache lines, plus one line of slack for alignment
+        size_t padded = (n + 7) / 8 * 8;
+        storage.resize(padded * 4 + 8);
+
+        size_t misalignment = reinterpret_cast<uintptr_t>(storage.data()) % 64;
+        double* base = storage.data() + (misalignment == 0 ? 0 : (64 - misalignment) / sizeof(double));
+
+        scalar = base;
+        i = base + padded;
+        j = base + padded * 2;
+        k = base + padded * 3;
+    }
+
+    // The component pointers refer into storage, so copies would share them; moves keep the buffer
+    QuaternionArray(const QuaternionArray&) = delete;
+    QuaternionArray& operator=(const QuaternionArray&) = delete;
+    QuaternionArray(QuaternionArray&&) = default;
+    QuaternionArray& operator=(QuaternionArray&&) = default;
+
+    Quaternion get(size_t index) const {
+        return Quaternion(scalar[index], i[index], j[index], k[index]);
+    }
+
+    void set(size_t index, const Quaternion& quaternion) {
+        scalar[index] = quaternion.scalar;
+        i[index] = quaternion.i;
+        j[index] = quaternion.j;
+        k[index] = quaternion.k;
+    }
+};
+
+// Function to check that two quaternion arrays can be combined elementwise
+void checkQuaternionArraySizes(size_t a, size_t b) {
+    if (a != b) {
+        cerr << "Error: Quaternion arrays have different lengths." << endl;
+        exit(1);
+    }
+}
+
+// Elementwise kernels over one component array at a time. With only three streams per loop the
+// compiler's runtime overlap check is cheap and the loop vectorizes, even when out is an input.
+inline void addComponents(const double* a, const double* b, double* out, size_t count) {
+    for (size_t n = 0; n < count; n++) {
+        out[n] = a[n] + b[n];
+    }
+}
+
+inline void subtractComponents(const double* a, const double* b, double* out, size_t count) {
+    for (size_t n = 0; n < count; n++) {
+        out[n] = a[n] - b[n];
+    }
+}
+
+inline void scaleComponents(const double* in, double scalar, double* out, size_t count) {
+    for (size_t n = 0; n < count; n++) {
+        out[n] = in[n] * scalar;
+    }
+}
+
+// Function to add two quaternion arrays elementwise; out may be either input
+void addQuaternionArrays(const QuaternionArray& a, const QuaternionArray& b, QuaternionArray& out) {
+    checkQuaternionArraySizes(a.count, b.count);
+    checkQuaternionArraySizes(a.count, out.count);
+
+    addComponents(a.scalar, b.scalar, out.scalar, a.count);
+    addComponents(a.i, b.i, out.i, a.count);
+    addComponents(a.j, b.j, out.j, a.count);
+    addComponents(a.k, b.k, out.k, a.count);
+}
+
+// Function to subtract two quaternion arrays elementwise; out may be either input
+void subtractQuaternionArrays(const QuaternionArray& a, const QuaternionArray& b, QuaternionArray& out) {
+    checkQuaternionArraySizes(a.count, b.count);
+    checkQuaternionArraySizes(a.count, out.count);
+
+    subtractComponents(a.scalar, b.scalar, out.scalar, a.count);
+    subtractComponents(a.i, b.i, out.i, a.count);
+    subtractComponents(a.j, b.j, out.j, a.count);
+    subtractComponents(a.k, b.k, out.k, a.count);
+}
+
+// Function to multiply two quaternion arrays elementwise (Hamilton product); out may be either input
+void multiplyQuaternionArrays(const QuaternionArray& a, const QuaternionArray& b, QuaternionArray& out) {
+    checkQuaternionArraySizes(a.count, b.count);
+    checkQuaternionArraySizes(a.count, out.count);
+
+    size_t n = 0;
+
+#if defined(__AVX512F__)
+    for (; n + 8 <= a.count; n += 8) {
+        __m512d as = _mm512_load_pd(a.scalar + n), ai = _mm512_load_pd(a.i + n), aj = _mm512_load_pd(a.j + n), ak = _mm512_load_pd(a.k + n);
+        __m512d bs = _mm512_load_pd(b.scalar + n), bi = _mm512_load_pd(b.i + n), bj = _mm512_load_pd(b.j + n), bk = _mm512_load_pd(b.k + n);
+
+        __m512d s = _mm512_sub_pd(_mm512_sub_pd(_mm512_sub_pd(_mm512_mul_pd(as, bs), _mm512_mul_pd(ai, bi)), _mm512_mul_pd(aj, bj)), _mm512_mul_pd(ak, bk));
+        __m512d x = _mm512_sub_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(as, bi), _mm512_mul_pd(ai, bs)), _mm512_mul_pd(aj, bk)), _mm512_mul_pd(ak, bj));
+        __m512d y = _mm512_add_pd(_mm512_add_pd(_mm512_sub_pd(_mm512_mul_pd(as, bj), _mm512_mul_pd(ai, bk)), _mm512_mul_pd(aj, bs)), _mm512_mul_pd(ak, bi));
+        __m512d z = _mm512_add_pd(_mm512_sub_pd(_mm512_add_pd(_mm512_mul_pd(as, bk), _mm512_mul_pd(ai, bj)), _mm512_mul_pd(aj, bi)), _mm512_mul_pd(ak, bs));
+
+        _mm512_store_pd(out.scalar + n, s);
+        _mm512_store_pd(out.i + n, x);
+        _mm512_store_pd(out.j + n, y);
+        _mm512_store_pd(out.k + n, z);
+    }
+#elif defined(__AVX__)
+    for (; n + 4 <= a.count; n += 4) {
+        __m256d as = _mm256_load_pd(a.scalar + n), ai = _mm256_load_pd(a.i + n), aj = _mm256_load_pd(a.j + n), ak = _mm256_load_pd(a.k + n);
+        __m256d bs = _mm256_load_pd(b.scalar + n), bi = _mm256_load_pd(b.i + n), bj = _mm256_load_pd(b.j + n), bk = _mm256_load_pd(b.k + n);
+
+        __m256d s = _mm256_sub_pd(_mm256_sub_pd(_mm256_sub_pd(_mm256_mul_pd(as, bs), _mm256_mul_pd(ai, bi)), _mm256_mul_pd(aj, bj)), _mm256_mul_pd(ak, bk));
+        __m256d x = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(as, bi), _mm256_mul_pd(ai, bs)), _mm256_mul_pd(aj, bk)), _mm256_mul_pd(ak, bj));
+        __m256d y = _mm256_add_pd(_mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(as, bj), _mm256_mul_pd(ai, bk)), _mm256_mul_pd(aj, bs)), _mm256_mul_pd(ak, bi));
+        __m256d z = _mm256_add_pd(_mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(as, bk), _mm256_mul_pd(ai, bj)), _mm256_mul_pd(aj, bi)), _mm256_mul_pd(ak, bs));
+
+        _mm256_store_pd(out.scalar + n, s);
+        _mm256_store_pd(out.i + n, x);
+        _mm256_store_pd(out.j + n, y);
+        _mm256_store_pd(out.k + n, z);
+    }
+#endif
+
+    // Remaining quaternions (all of them without AVX) use the same formula as multiplyQuaternions
+    for (; n < a.count; n++) {
+        double as = a.scalar[n], ai = a.i[n], aj = a.j[n], ak = a.k[n];
+        double bs = b.scalar[n], bi = b.i[n], bj = b.j[n], bk = b.k[n];
+
+        out.scalar[n] = as * bs - ai * bi - aj * bj - ak * bk;
+        out.i[n] = as * bi + ai * bs + aj * bk - ak * bj;
+        out.j[n] = as * bj - ai * bk + aj * bs + ak * bi;
+        out.k[n] = as * bk + ai * bj - aj * bi + ak * bs;
+    }
+}
+
+// Function to calculate the dot products of two quaternion arrays elementwise into out[0 .. count)
+void dotProductQuaternionArrays(const QuaternionArray& a, const QuaternionArray& b, double* out) {
+    checkQuaternionArraySizes(a.count, b.count);
+
+    size_t n = 0;
+
+#if defined(__AVX__)
+    for (; n + 4 <= a.count; n += 4) {
+        __m256d sum = _mm256_mul_pd(_mm256_load_pd(a.scalar + n), _mm256_load_pd(b.scalar + n));
+        sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_load_pd(a.i + n), _mm256_load_pd(b.i + n)));
+        sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_load_pd(a.j + n), _mm256_load_pd(b.j + n)));
+        sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_load_pd(a.k + n), _mm256_load_pd(b.k + n)));
+        _mm256_storeu_pd(out + n, sum);
+    }
+#endif
+
+    for (; n < a.count; n++) {
+        out[n] = a.scalar[n] * b.scalar[n] + a.i[n] * b.i[n] + a.j[n] * b.j[n] + a.k[n] * b.k[n];
+    }
+}
+
+// Function to calculate the conjugates of a quaternion array; out may be the input
+void conjugateQuaternionArray(const QuaternionArray& in, QuaternionArray& out) {
+    checkQuaternionArraySizes(in.count, out.count);
+
+    if (out.scalar != in.scalar) {
+        copy(in.scalar, in.scalar + in.count, out.scalar);
+    }
+    scaleComponents(in.i, -1.0, out.i, in.count);
+    scaleComponents(in.j, -1.0, out.j, in.count);
+    scaleComponents(in.k, -1.0, out.k, in.count);
+}
+
+// Function to multiply a quaternion array by a scalar value; out may be the input
+void scaleQuaternionArray(const QuaternionArray& in, double scalar, QuaternionArray& out) {
+    checkQuaternionArraySizes(in.count, out.count);
+
+    scaleComponents(in.scalar, scalar, out.scalar, in.count);
+    scaleComponents(in.i, scalar, out.i, in.count);
+    scaleComponents(in.j, scalar, out.j, in.count);
+    scaleComponents(in.k, scalar, out.k, in.count);
+}
+
+// Function to calculate the inverses of a quaternion array; out may be the input.
+// Returns false if any quaternion is zero, in which case its inverse is not finite.
+bool inverseQuaternionArray(const QuaternionArray& in, QuaternionArray& out) {
+    checkQuaternionArraySizes(in.count, out.count);
+
+    bool invertible = true;
+
+    for (size_t n = 0; n < in.count; n++) {
+        double normSquared = in.scalar[n] * in.scalar[n] + in.i[n] * in.i[n] + in.j[n] * in.j[n] + in.k[n] * in.k[n];
+        double factor = 1.0 / normSquared;
+        invertible &= (normSquared != 0.0);
+
+        out.scalar[n] = in.scalar[n] * factor;
+        out.i[n] = -in.i[n] * factor;
+        out.j[n] = -in.j[n] * factor;
+        out.k[n] = -in.k[n] * factor;
+    }
+
+    return invertible;
+}
+
+// Number of quaternions worth handing to one thread
+const size_t PARALLEL_GRAIN = 65536;
+
+// Function to pick how many threads to use for work spread over a number of quaternions
+inline int chooseThreadCount(size_t count) {
+    return ParallelCore::chooseThreadCount(count, PARALLEL_GRAIN);
+}
+
+// Function to multiply quaternions [begin, end) of an array left to right onto carry, optionally storing
+// every partial product. For chains of unit rotations, the running product is renormalized every
+// renormalizeInterval steps to stop rounding drift from accumulating (0 never renormalizes).
+Quaternion composeQuaternionRange(const QuaternionArray& in, size_t begin, size_t end, Quaternion carry,
+    size_t renormalizeInterval, QuaternionArray* out) {
+    size_t sinceRenormalize = 0;
+
+    for (size_t n = begin; n < end; n++) {
+        carry = multiplyQuaternions(carry, in.get(n));
+
+        if (renormalizeInterval != 0 && ++sinceRenormalize == renormalizeInterval) {
+            carry = normalizeQuaternion(carry);
+            sinceRenormalize = 0;
+        }
+
+        if (out != nullptr) {
+            out->set(n, carry);
+        }
+    }
+
+    return carry;
+}
+
+// Function to turn block totals into exclusive block prefixes with a Blelloch up-sweep / down-sweep.
+// Quaternion multiplication is associative but not commutative, so every combine keeps left-to-right order.
+void exclusiveScanQuaternions(vector<Quaternion>& values) {
+    size_t size = 1;
+    while (size < values.size()) {
+        size *= 2;
+    }
+
+    size_t original = values.size();
+    values.resize(size, Quaternion(1.0));
+
+    // Up-sweep: each right node becomes the product of its subtree
+    for (size_t stride = 1; stride < size; stride *= 2) {
+        for (size_t n = 0; n < size; n += 2 * stride) {
+            values[n + 2 * stride - 1] = multiplyQuaternions(values[n + stride - 1], values[n + 2 * stride - 1]);
+        }
+    }
+
+    // Down-sweep: a left child takes its parent's prefix, a right child takes that prefix times the left subtree
+    values[size - 1] = Quaternion(1.0);
+
+    for (size_t stride = size / 2; stride >= 1; stride /= 2) {
+        for (size_t n = 0; n < size; n += 2 * stride) {
+            Quaternion left = values[n + stride - 1];
+            values[n + stride - 1] = values[n + 2 * stride - 1];
+            values[n + 2 * stride - 1] = multiplyQuaternions(values[n + 2 * stride - 1], left);
+        }
+    }
+
+    values.resize(original);
+}
+
+// Function to multiply all quaternions of an array together, left to right, across threads
+Quaternion reduceQuaternionArray(const QuaternionArray& in, size_t renormalizeInterval) {
+    int threadCount = chooseThreadCount(in.count);
+    vector<Quaternion> totals(threadCount, Quaternion(1.0));
+
+    ParallelCore::runInParallel(in.count, threadCount, [&](int t, size_t begin, size_t end) {
+        totals[t] = composeQuaternionRange(in, begin, end, Quaternion(1.0), renormalizeInterval, nullptr);
+    });
+
+    Quaternion result(1.0);
+    for (const Quaternion& total : totals) {
+        result = multiplyQuaternions(result, total);
+    }
+
+    return renormalizeInterval != 0 ? normalizeQuaternion(result) : result;
+}
+
+// Function to store every cumulative product q0 * q1 * ... * qn of an array into out, across threads.
+// Each thread reduces its block, the block totals are exclusive-scanned, then each thread rescans its
+// block starting from its prefix: O(n / p + log p) steps on p threads.
+void scanQuaternionArray(const QuaternionArray& in, QuaternionArray& out, size_t renormalizeInterval) {
+    checkQuaternionArraySizes(in.count, out.count);
+
+    int threadCount = chooseThreadCount(in.count);
+    vector<Quaternion> prefixes(threadCount, Quaternion(1.0));
+
+    if (threadCount > 1) {
+        ParallelCore::runInParallel(in.count, threadCount, [&](int t, size_t begin, size_t end) {
+            prefixes[t] = composeQuaternionRange(in, begin, end, Quaternion(1.0), renormalizeInterval, nullptr);
+        });
+
+        exclusiveScanQuaternions(prefixes);
+    }
+
+    ParallelCore::runInParallel(in.count, threadCount, [&](int t, size_t begin, size_t end) {
+        composeQuaternionRange(in, begin, end, prefixes[t], renormalizeInterval, &out);
+    });
+}
+
+// Function to calculate the inverses of an array of unit quaternions, which are their conjugates; out may be the input
+void unitInverseQuaternionArray(const QuaternionArray& in, QuaternionArray& out) {
+    conjugateQuaternionArray(in, out);
+}
+
+// Function to scale every quaternion of an array to unit length with an exact 1 / sqrt; out may be the input.
+// Zero quaternions are left unchanged.
+void normalizeQuaternionArray(const QuaternionArray& in, QuaternionArray& out) {
+    checkQuaternionArraySizes(in.count, out.count);
+
+    for (size_t n = 0; n < in.count; n++) {
+        double normSquared = in.scalar[n] * in.scalar[n] + in.i[n] * in.i[n] + in.j[n] * in.j[n] + in.k[n] * in.k[n];
+        double factor = normSquared > 0.0 ? 1.0 / sqrt(normSquared) : 1.0;
+
+        out.scalar[n] = in.scalar[n] * factor;
+        out.i[n] = in.i[n] * factor;
+        out.j[n] = in.j[n] * factor;
+        out.k[n] = in.k[n] * factor;
+    }
+}
+
+// Function to scale every quaternion of an array to unit length with a hardware reciprocal square root
+// estimate refined by one Newton step, y' = y (1.5 - 0.5 x y^2); out may be the input. The result's
+// norm is within about 2e-7 of one with AVX (12-bit estimate) and 1e-8 with AVX-512 (14-bit estimate),
+// which suits quaternions that are renormalized regularly. Without AVX this is normalizeQuaternionArray.
+// Zero quaternions must not be passed.
+void normalizeQuaternionArrayFast(const QuaternionArray& in, QuaternionArray& out) {
+    checkQuaternionArraySizes(in.count, out.count);
+
+    size_t n = 0;
+
+#if defined(__AVX512F__)
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d threeHalves = _mm512_set1_pd(1.5);
+
+    for (; n + 8 <= in.count; n += 8) {
+        __m512d s = _mm512_load_pd(in.scalar + n), x = _mm512_load_pd(in.i + n), y = _mm512_load_pd(in.j + n), z = _mm512_load_pd(in.k + n);
+        __m512d normSquared = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(s, s), _mm512_mul_pd(x, x)), _mm512_add_pd(_mm512_mul_pd(y, y), _mm512_mul_pd(z, z)));
+
+        __m512d estimate = _mm512_rsqrt14_pd(normSquared);
+        __m512d correction = _mm512_sub_pd(threeHalves, _mm512_mul_pd(_mm512_mul_pd(half, normSquared), _mm512_mul_pd(estimate, estimate)));
+        __m512d factor = _mm512_mul_pd(estimate, correction);
+
+        _mm512_store_pd(out.scalar + n, _mm512_mul_pd(s, factor));
+        _mm512_store_pd(out.i + n, _mm512_mul_pd(x, factor));
+        _mm512_store_pd(out.j + n, _mm512_mul_pd(y, factor));
+        _mm512_store_pd(out.k + n, _mm512_mul_pd(z, factor));
+    }
+#elif defined(__AVX__)
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d threeHalves = _mm256_set1_pd(1.5);
+
+    for (; n + 4 <= in.count; n += 4) {
+        __m256d s = _mm256_load_pd(in.scalar + n), x = _mm256_load_pd(in.i + n), y = _mm256_load_pd(in.j + n), z = _mm256_load_pd(in.k + n);
+        __m256d normSquared = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(s, s), _mm256_mul_pd(x, x)), _mm256_add_pd(_mm256_mul_pd(y, y), _mm256_mul_pd(z, z)));
+
+        // AVX has no double-precision estimate, so take the single-precision one and refine it in double
+        __m256d estimate = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(normSquared)));
+        __m256d correction = _mm256_sub_pd(threeHalves, _mm256_mul_pd(_mm256_mul_pd(half, normSquared), _mm256_mul_pd(estimate, estimate)));
+        __m256d factor = _mm256_mul_pd(estimate, correction);
+
+        _mm256_store_pd(out.scalar + n, _mm256_mul_pd(s, factor));
+        _mm256_store_pd(out.i + n, _mm256_mul_pd(x, factor));
+        _mm256_store_pd(out.j + n, _mm256_mul_pd(y, factor));
+        _mm256_store_pd(out.k + n, _mm256_mul_pd(z, factor));
+    }
+#endif
+
+    for (; n < in.count; n++) {
+        double normSquared = in.scalar[n] * in.scalar[n] + in.i[n] * in.i[n] + in.j[n] * in.j[n] + in.k[n] * in.k[n];
+        double factor = 1.0 / sqrt(normSquared);
+
+        out.scalar[n] = in.scalar[n] * factor;
+        out.i[n] = in.i[n] * factor;
+        out.j[n] = in.j[n] * factor;
+        out.k[n] = in.k[n] * factor;
+    }
+}
+
+// Function to find how far the norms of an array of quaternions are from one
+double largestUnitNormError(const QuaternionArray& quaternions) {
+    double largest = 0.0;
+
+    for (size_t n = 0; n < quaternions.count; n++) {
+        largest = max(largest, fabs(sqrt(calculateDotProduct(quaternions.get(n), quaternions.get(n))) - 1.0));
+    }
+
+    return largest;
+}
+
+// Structure to represent a 3D vector, such as a rotation vector or a point
+struct Vector3 {
+    double x;
+    double y;
+    double z;
+
+    Vector3(double x = 0.0, double y = 0.0, double z = 0.0)
+        : x(x), y(y), z(z) {}
+};
+
+// Structure to hold many 3D vectors as three separate component arrays, laid out like QuaternionArray
+struct Vector3Array {
+    size_t count = 0;
+    double* x = nullptr;
+    double* y = nullptr;
+    double* z = nullptr;
+    vector<double> storage;
+
+    Vector3Array() {}
+
+    explicit Vector3Array(size_t n)
+        : count(n) {
+        size_t padded = (n + 7) / 8 * 8;
+        storage.resize(padded * 3 + 8);
+
+        size_t misalignment = reinterpret_cast<uintptr_t>(storage.data()) % 64;
+        double* base = storage.data() + (misalignment == 0 ? 0 : (64 - misalignment) / sizeof(double));
+
+        x = base;
+        y = base + padded;
+        z = base + padded * 2;
+    }
+
+    Vector3Array(const Vector3Array&) = delete;
+    Vector3Array& operator=(const Vector3Array&) = delete;
+    Vector3Array(Vector3Array&&) = default;
+    Vector3Array& operator=(Vector3Array&&) = default;
+
+    Vector3 get(size_t index) const {
+        return Vector3(x[index], y[index], z[index]);
+    }
+
+    void set(size_t index, const Vector3& vector) {
+        x[index] = vector.x;
+        y[index] = vector.y;
+        z[index] = vector.z;
+    }
+};
+
+// Function to calculate the exponential of a quaternion, e^s (cos|v| + sin|v| v / |v|)
+Quaternion exponentialQuaternion(const Quaternion& quaternion) {
+    double angle = sqrt(quaternion.i * quaternion.i + quaternion.j * quaternion.j + quaternion.k * quaternion.k);
+    double scale = exp(quaternion.scalar);
+    double factor = angle > 0.0 ? scale * sin(angle) / angle : scale;
+
+    return Quaternion(scale * cos(angle), quaternion.i * factor, quaternion.j * factor, quaternion.k * factor);
+}
+
+// Function to calculate the logarithm of a non-zero quaternion, ln|q| + atan2(|v|, s) v / |v|.
+// A negative real quaternion has no unique logarithm; its vector part is returned as zero.
+Quaternion logarithmQuaternion(const Quaternion& quaternion) {
+    double vectorNorm = sqrt(quaternion.i * quaternion.i + quaternion.j * quaternion.j + quaternion.k * quaternion.k);
+    double factor = vectorNorm > 0.0 ? atan2(vectorNorm, quaternion.scalar) / vectorNorm : 0.0;
+
+    return Quaternion(0.5 * log(calculateDotProduct(quaternion, quaternion)),
+        quaternion.i * factor, quaternion.j * factor, quaternion.k * factor);
+}
+
+// Function to raise a non-zero quaternion to a real power, e^(t ln q)
+Quaternion powerQuaternion(const Quaternion& quaternion, double exponent) {
+    return exponentialQuaternion(multiplyByScalar(logarithmQuaternion(quaternion), exponent));
+}
+
+// Function to build the unit quaternion rotating by angle radians about an axis; the axis need not be unit length
+Quaternion axisAngleToQuaternion(const Vector3& axis, double angle) {
+    double axisNorm = sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+
+    if (axisNorm == 0.0) {
+        return Quaternion(1.0);
+    }
+
+    double factor = sin(0.5 * angle) / axisNorm;
+    return Quaternion(cos(0.5 * angle), axis.x * factor, axis.y * factor, axis.z * factor);
+}
+
+// Function to split a unit quaternion into a unit axis and an angle in [0, pi]; the identity gives the x axis
+void quaternionToAxisAngle(const Quaternion& quaternion, Vector3& axis, double& angle) {
+    double sign = quaternion.scalar < 0.0 ? -1.0 : 1.0;
+    double vectorNorm = sqrt(quaternion.i * quaternion.i + quaternion.j * quaternion.j + quaternion.k * quaternion.k);
+
+    if (vectorNorm == 0.0) {
+        axis = Vector3(1.0, 0.0, 0.0);
+        angle = 0.0;
+        return;
+    }
+
+    axis = Vector3(sign * quaternion.i / vectorNorm, sign * quaternion.j / vectorNorm, sign * quaternion.k / vectorNorm);
+    angle = 2.0 * atan2(vectorNorm, fabs(quaternion.scalar));
+}
+
+// Function to build the unit quaternion for a rotation vector (axis times angle), exp(r / 2)
+Quaternion rotationVectorToQuaternion(const Vector3& rotation) {
+    return exponentialQuaternion(Quaternion(0.0, 0.5 * rotation.x, 0.5 * rotation.y, 0.5 * rotation.z));
+}
+
+// Function to find the rotation vector of a unit quaternion, taking the shorter of q and -q so the angle is at most pi
+Vector3 quaternionToRotationVector(const Quaternion& quaternion) {
+    Vector3 axis;
+    double angle;
+    quaternionToAxisAngle(quaternion, axis, angle);
+
+    return Vector3(axis.x * angle, axis.y * angle, axis.z * angle);
+}
+
+// Branch-free polynomial approximations for the batched functions below, which use them for the scalar
+// tail and for builds without AVX2. Each bound is the largest error measured against libm over
+// 2 * 10^7 random arguments in the stated range.
+
+// Function to round to the nearest integer by adding and subtracting 1.5 * 2^52; valid for |x| < 2^51
+inline double roundToInteger(double x) {
+    const double shifter = 6755399441055744.0;
+    return (x + shifter) - shifter;
+}
+
+// Function to approximate sin(x) and cos(x) together. x is reduced by the nearest multiple of pi / 2
+// (pi / 2 split in three parts, exact for |x| < 10^6) into [-pi / 4, pi / 4], where the fdlibm minimax
+// polynomials of degree 13 and 14 apply. Max absolute error 2.3e-16 for |x| < 10^6.
+inline void approximateSinCos(double x, double& sine, double& cosine) {
+    const double twoOverPi = 6.36619772367581382433e-01;
+    const double halfPi1 = 1.57079632673412561417e+00;
+    const double halfPi2 = 6.07710050630396597660e-11;
+    const double halfPi3 = 2.02226624879595063154e-21;
+
+    double quadrant = roundToInteger(x * twoOverPi);
+    double r = ((x - quadrant * halfPi1) - quadrant * halfPi2) - quadrant * halfPi3;
+    double r2 = r * r;
+
+    double sinR = r + r * r2 * (-1.66666666666666324348e-01 + r2 * (8.33333333332248946124e-03 +
+        r2 * (-1.98412698298579493134e-04 + r2 * (2.75573137070700676789e-06 +
+        r2 * (-2.50507602534068634195e-08 + r2 * 1.58969099521155010221e-10)))));
+    double cosR = 1.0 - 0.5 * r2 + r2 * r2 * (4.16666666666666019037e-02 + r2 * (-1.38888888888741095749e-03 +
+        r2 * (2.48015872894767294178e-05 + r2 * (-2.75573143513906633035e-07 +
+        r2 * (2.08757232129817482790e-09 + r2 * -1.13596475577881948265e-11)))));
+
+    // Quadrant n mod 4 picks (sin, cos) = (s, c), (c, -s), (-s, -c) or (-c, s)
+    int64_t n = static_cast<int64_t>(quadrant);
+    bool swap = (n & 1) != 0;
+    sine = (swap ? cosR : sinR) * ((n & 2) != 0 ? -1.0 : 1.0);
+    cosine = (swap ? sinR : cosR) * (((n + 1) & 2) != 0 ? -1.0 : 1.0);
+}
+
+// Function to approximate atan2(y, x) for y >= 0, giving an angle in [0, pi]. The ratio of the smaller to
+// the larger of |x| and y is folded below tan(pi / 8) by atan(a) = pi / 4 + atan((a - 1) / (a + 1)), then
+// halved once more by atan(a) = 2 atan(a / (1 + sqrt(1 + a^2))) so a Taylor series to degree 19 converges.
+// Max absolute error 4.5e-16; atan2(0, 0) is 0.
+inline double approximateAtan2(double y, double x) {
+    const double quarterPi = 7.85398163397448278999e-01;
+    const double halfPi = 1.57079632679489655800e+00;
+    const double pi = 3.14159265358979311600e+00;
+    const double tanEighthPi = 4.14213562373095145475e-01;
+
+    double absX = fabs(x);
+    double larger = max(absX, y);
+    double smaller = min(absX, y);
+    double a = larger > 0.0 ? smaller / larger : 0.0;
+
+    bool folded = a > tanEighthPi;
+    a = folded ? (a - 1.0) / (a + 1.0) : a;
+
+    double t = a / (1.0 + sqrt(1.0 + a * a));
+    double t2 = t * t;
+    double series = t * (1.0 + t2 * (-1.0 / 3 + t2 * (1.0 / 5 + t2 * (-1.0 / 7 + t2 * (1.0 / 9 + t2 * (-1.0 / 11 +
+        t2 * (1.0 / 13 + t2 * (-1.0 / 15 + t2 * (1.0 / 17 + t2 * (-1.0 / 19))))))))));
+
+    double angle = 2.0 * series + (folded ? quarterPi : 0.0);
+    angle = absX < y ? halfPi - angle : angle;
+    return x < 0.0 ? pi - angle : angle;
+}
+
+// Function to approximate ln(x) for positive normal x. x = m 2^e with m in [sqrt(1/2), sqrt(2)), read from
+// the bits, and ln(m) = 2 atanh((m - 1) / (m + 1)) as a series to degree 19. Max relative error 2.3e-16.
+inline double approximateLog(double x) {
+    const double ln2 = 6.93147180559945286227e-01;
+    const double sqrtTwo = 1.41421356237309514547e+00;
+
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    double exponent = static_cast<double>(static_cast<int64_t>(bits >> 52) - 1023);
+    bits = (bits & 0x000FFFFFFFFFFFFFull) | 0x3FF0000000000000ull;
+
+    double mantissa;
+    memcpy(&mantissa, &bits, sizeof(mantissa));
+
+    bool high = mantissa > sqrtTwo;
+    mantissa = high ? 0.5 * mantissa : mantissa;
+    exponent = high ? exponent + 1.0 : exponent;
+
+    double u = (mantissa - 1.0) / (mantissa + 1.0);
+    double u2 = u * u;
+    double series = u * (2.0 + u2 * (2.0 / 3 + u2 * (2.0 / 5 + u2 * (2.0 / 7 + u2 * (2.0 / 9 + u2 * (2.0 / 11 +
+        u2 * (2.0 / 13 + u2 * (2.0 / 15 + u2 * (2.0 / 17 + u2 * (2.0 / 19))))))))));
+
+    return exponent * ln2 + series;
+}
+
+// Function to approximate e^x for |x| < 708. x = k ln 2 + r with |r| <= ln 2 / 2 (ln 2 split in two
+// parts), e^r is a Taylor polynomial of degree 13 and 2^k is built in the exponent bits.
+// Max relative error 2.5e-16.
+inline double approximateExp(double x) {
+    const double inverseLn2 = 1.44269504088896338700e+00;
+    const double ln2High = 6.93147180369123816490e-01;
+    const double ln2Low = 1.90821492927058770002e-10;
+
+    double k = roundToInteger(x * inverseLn2);
+    double r = (x - k * ln2High) - k * ln2Low;
+
+    double series = 1.0 + r * (1.0 + r * (1.0 / 2 + r * (1.0 / 6 + r * (1.0 / 24 + r * (1.0 / 120 + r * (1.0 / 720 +
+        r * (1.0 / 5040 + r * (1.0 / 40320 + r * (1.0 / 362880 + r * (1.0 / 3628800 + r * (1.0 / 39916800 +
+        r * (1.0 / 479001600 + r * (1.0 / 6227020800.0)))))))))))));
+
+    uint64_t bits = static_cast<uint64_t>(static_cast<int64_t>(k) + 1023) << 52;
+    double scale;
+    memcpy(&scale, &bits, sizeof(scale));
+
+    return series * scale;
+}
+
+#if defined(__AVX2__)
+// Four-lane AVX2 versions of the approximations above: the same reductions and polynomials, with the
+// selects done by compare masks and the bit manipulation by 64-bit integer operations
+inline __m256d approximatePolynomial4(__m256d x, const double* coefficients, int degree) {
+    __m256d result = _mm256_set1_pd(coefficients[degree]);
+    for (int c = degree - 1; c >= 0; c--) {
+        result = _mm256_add_pd(_mm256_mul_pd(result, x), _mm256_set1_pd(coefficients[c]));
+    }
+    return result;
+}
+
+inline void approximateSinCos4(__m256d x, __m256d& sine, __m256d& cosine) {
+    static const double sinCoefficients[] = { -1.66666666666666324348e-01, 8.33333333332248946124e-03, -1.98412698298579493134e-04,
+        2.75573137070700676789e-06, -2.50507602534068634195e-08, 1.58969099521155010221e-10 };
+    static const double cosCoefficients[] = { 4.16666666666666019037e-02, -1.38888888888741095749e-03, 2.48015872894767294178e-05,
+        -2.75573143513906633035e-07, 2.08757232129817482790e-09, -1.13596475577881948265e-11 };
+    const __m256d shifter = _mm256_set1_pd(6755399441055744.0);
+
+    __m256d shifted = _mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(6.36619772367581382433e-01)), shifter);
+    __m256d quadrant = _mm256_sub_pd(shifted, shifter);
+    __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(quadrant, _mm256_set1_pd(1.57079632673412561417e+00)));
+    r = _mm256_sub_pd(r, _mm256_mul_pd(quadrant, _mm256_set1_pd(6.07710050630396597660e-11)));
+    r = _mm256_sub_pd(r, _mm256_mul_pd(quadrant, _mm256_set1_pd(2.02226624879595063154e-21)));
+    __m256d r2 = _mm256_mul_pd(r, r);
+
+    __m256d sinR = _mm256_add_pd(r, _mm256_mul_pd(_mm256_mul_pd(r, r2), approximatePolynomial4(r2, sinCoefficients, 5)));
+    __m256d cosR = _mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(_mm256_set1_pd(0.5), r2));
+    cosR = _mm256_add_pd(cosR, _mm256_mul_pd(_mm256_mul_pd(r2, r2), approximatePolynomial4(r2, cosCoefficients, 5)));
+
+    // The low mantissa bits of the shifted value hold the quadrant number n
+    __m256i n = _mm256_castpd_si256(shifted);
+    __m256d swap = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(n, _mm256_set1_epi64x(1)), _mm256_set1_epi64x(1)));
+    __m256d sinSign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(n, _mm256_set1_epi64x(2)), 62));
+    __m256d cosSign = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_and_si256(_mm256_add_epi64(n, _mm256_set1_epi64x(1)), _mm256_set1_epi64x(2)), 62));
+
+    sine = _mm256_xor_pd(_mm256_blendv_pd(sinR, cosR, swap), sinSign);
+    cosine = _mm256_xor_pd(_mm256_blendv_pd(cosR, sinR, swap), cosSign);
+}
+
+inline __m256d approximateAtan2_4(__m256d y, __m256d x) {
+    static const double atanCoefficients[] = { 1.0, -1.0 / 3, 1.0 / 5, -1.0 / 7, 1.0 / 9, -1.0 / 11, 1.0 / 13, -1.0 / 15, 1.0 / 17, -1.0 / 19 };
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d zero = _mm256_setzero_pd();
+
+    __m256d absX = _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);
+    __m256d larger = _mm256_max_pd(absX, y);
+    __m256d smaller = _mm256_min_pd(absX, y);
+    __m256d a = _mm256_and_pd(_mm256_div_pd(smaller, larger), _mm256_cmp_pd(larger, zero, _CMP_GT_OQ));
+
+    __m256d folded = _mm256_cmp_pd(a, _mm256_set1_pd(4.14213562373095145475e-01), _CMP_GT_OQ);
+    a = _mm256_blendv_pd(a, _mm256_div_pd(_mm256_sub_pd(a, one), _mm256_add_pd(a, one)), folded);
+
+    __m256d t = _mm256_div_pd(a, _mm256_add_pd(one, _mm256_sqrt_pd(_mm256_add_pd(one, _mm256_mul_pd(a, a)))));
+    __m256d series = _mm256_mul_pd(t, approximatePolynomial4(_mm256_mul_pd(t, t), atanCoefficients, 9));
+
+    __m256d angle = _mm256_add_pd(_mm256_add_pd(series, series), _mm256_and_pd(folded, _mm256_set1_pd(7.85398163397448278999e-01)));
+    angle = _mm256_blendv_pd(angle, _mm256_sub_pd(_mm256_set1_pd(1.57079632679489655800e+00), angle), _mm256_cmp_pd(absX, y, _CMP_LT_OQ));
+    return _mm256_blendv_pd(angle, _mm256_sub_pd(_mm256_set1_pd(3.14159265358979311600e+00), angle), _mm256_cmp_pd(x, zero, _CMP_LT_OQ));
+}
+
+inline __m256d approximateLog4(__m256d x) {
+    static const double logCoefficients[] = { 2.0, 2.0 / 3, 2.0 / 5, 2.0 / 7, 2.0 / 9, 2.0 / 11, 2.0 / 13, 2.0 / 15, 2.0 / 17, 2.0 / 19 };
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d twoPow52 = _mm256_set1_pd(4503599627370496.0);
+
+    // AVX2 has no 64-bit integer to double conversion, so place the biased exponent in the mantissa of 2^52
+    __m256i bits = _mm256_castpd_si256(x);
+    __m256d exponent = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_castpd_si256(twoPow52))), twoPow52);
+    exponent = _mm256_sub_pd(exponent, _mm256_set1_pd(1023.0));
+
+    __m256i mantissaBits = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFll)), _mm256_castpd_si256(one));
+    __m256d mantissa = _mm256_castsi256_pd(mantissaBits);
+
+    __m256d high = _mm256_cmp_pd(mantissa, _mm256_set1_pd(1.41421356237309514547e+00), _CMP_GT_OQ);
+    mantissa = _mm256_blendv_pd(mantissa, _mm256_mul_pd(_mm256_set1_pd(0.5), mantissa), high);
+    exponent = _mm256_add_pd(exponent, _mm256_and_pd(high, one));
+
+    __m256d u = _mm256_div_pd(_mm256_sub_pd(mantissa, one), _mm256_add_pd(mantissa, one));
+    __m256d series = _mm256_mul_pd(u, approximatePolynomial4(_mm256_mul_pd(u, u), logCoefficients, 9));
+
+    return _mm256_add_pd(_mm256_mul_pd(exponent, _mm256_set1_pd(6.93147180559945286227e-01)), series);
+}
+
+inline __m256d approximateExp4(__m256d x) {
+    static const double expCoefficients[] = { 1.0, 1.0, 1.0 / 2, 1.0 / 6, 1.0 / 24, 1.0 / 120, 1.0 / 720, 1.0 / 5040, 1.0 / 40320,
+        1.0 / 362880, 1.0 / 3628800, 1.0 / 39916800, 1.0 / 479001600, 1.0 / 6227020800.0 };
+    const __m256d shifter = _mm256_set1_pd(6755399441055744.0);
+
+    __m256d shifted = _mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(1.44269504088896338700e+00)), shifter);
+    __m256d k = _mm256_sub_pd(shifted, shifter);
+    __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(6.93147180369123816490e-01)));
+    r = _mm256_sub_pd(r, _mm256_mul_pd(k, _mm256_set1_pd(1.90821492927058770002e-10)));
+
+    // The low mantissa bits of the shifted value hold k; shifting k + 1023 into the exponent field gives 2^k
+    __m256i scaleBits = _mm256_slli_epi64(_mm256_add_epi64(_mm256_castpd_si256(shifted), _mm256_set1_epi64x(1023)), 52);
+
+    return _mm256_mul_pd(approximatePolynomial4(r, expCoefficients, 13), _mm256_castsi256_pd(scaleBits));
+}
+#endif
+
+// Function to calculate the exponentials of a quaternion array with the polynomial approximations; out may be the input
+void exponentialQuaternionArray(const QuaternionArray& in, QuaternionArray& out) {
+    checkQuaternionArraySizes(in.count, out.count);
+
+    size_t n = 0;
+
+#if defined(__AVX2__)
+    for (; n + 4 <= in.count; n += 4) {
+        __m256d s = _mm256_load_pd(in.scalar + n), x = _mm256_load_pd(in.i + n), y = _mm256_load_pd(in.j + n), z = _mm256_load_pd(in.k + n);
+        __m256d angle = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), _mm256_mul_pd(z, z)));
+        __m256d scale = approximateExp4(s);
+        __m256d sine, cosine;
+        approximateSinCos4(angle, sine, cosine);
+        __m256d factor = _mm256_blendv_pd(scale, _mm256_div_pd(_mm256_mul_pd(scale, sine), angle), _mm256_cmp_pd(angle, _mm256_setzero_pd(), _CMP_GT_OQ));
+
+        _mm256_store_pd(out.scalar + n, _mm256_mul_pd(scale, cosine));
+        _mm256_store_pd(out.i + n, _mm256_mul_pd(x, factor));
+        _mm256_store_pd(out.j + n, _mm256_mul_pd(y, factor));
+        _mm256_store_pd(out.k + n, _mm256_mul_pd(z, factor));
+    }
+#endif
+
+    for (; n < in.count; n++) {
+        double angle = sqrt(in.i[n] * in.i[n] + in.j[n] * in.j[n] + in.k[n] * in.k[n]);
+        double scale = approximateExp(in.scalar[n]);
+        double sine, cosine;
+        approximateSinCos(angle, sine, cosine);
+        double factor = angle > 0.0 ? scale * sine / angle : scale;
+
+        out.scalar[n] = scale * cosine;
+        out.i[n] = in.i[n] * factor;
+        out.j[n] = in.j[n] * factor;
+        out.k[n] = in.k[n] * factor;
+    }
+}
+
+// Function to calculate the logarithms of an array of non-zero quaternions with the polynomial approximations;
+// out may be the input
+void logarithmQuaternionArray(const QuaternionArray& in, QuaternionArray& out) {
+    checkQuaternionArraySizes(in.count, out.count);
+
+    size_t n = 0;
+
+#if defined(__AVX2__)
+    for (; n + 4 <= in.count; n += 4) {
+        __m256d s = _mm256_load_pd(in.scalar + n), x = _mm256_load_pd(in.i + n), y = _mm256_load_pd(in.j + n), z = _mm256_load_pd(in.k + n);
+        __m256d vectorNormSquared = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), _mm256_mul_pd(z, z));
+        __m256d vectorNorm = _mm256_sqrt_pd(vectorNormSquared);
+        __m256d factor = _mm256_and_pd(_mm256_div_pd(approximateAtan2_4(vectorNorm, s), vectorNorm), _mm256_cmp_pd(vectorNorm, _mm256_setzero_pd(), _CMP_GT_OQ));
+
+        _mm256_store_pd(out.scalar + n, _mm256_mul_pd(_mm256_set1_pd(0.5), approximateLog4(_mm256_add_pd(_mm256_mul_pd(s, s), vectorNormSquared))));
+        _mm256_store_pd(out.i + n, _mm256_mul_pd(x, factor));
+        _mm256_store_pd(out.j + n, _mm256_mul_pd(y, factor));
+        _mm256_store_pd(out.k + n, _mm256_mul_pd(z, factor));
+    }
+#endif
+
+    for (; n < in.count; n++) {
+        double vectorNormSquared = in.i[n] * in.i[n] + in.j[n] * in.j[n] + in.k[n] * in.k[n];
+        double vectorNorm = sqrt(vectorNormSquared);
+        double factor = vectorNorm > 0.0 ? approximateAtan2(vectorNorm, in.scalar[n]) / vectorNorm : 0.0;
+
+        out.scalar[n] = 0.5 * approximateLog(in.scalar[n] * in.scalar[n] + vectorNormSquared);
+        out.i[n] = in.i[n] * factor;
+        out.j[n] = in.j[n] * factor;
+        out.k[n] = in.k[n] * factor;
+    }
+}
+
+// Function to raise every quaternion of an array of non-zero quaternions to a real power; out may be the input
+void powerQuaternionArray(const QuaternionArray& in, double exponent, QuaternionArray& out) {
+    logarithmQuaternionArray(in, out);
+    scaleQuaternionArray(out, exponent, out);
+    exponentialQuaternionArray(out, out);
+}
+
+// Function to build unit quaternions from an array of rotation vectors
+void rotationVectorsToQuaternions(const Vector3Array& in, QuaternionArray& out) {
+    checkQuaternionArraySizes(in.count, out.count);
+
+    size_t n = 0;
+
+#if defined(__AVX2__)
+    for (; n + 4 <= in.count; n += 4) {
+        __m256d x = _mm256_load_pd(in.x + n), y = _mm256_load_pd(in.y + n), z = _mm256_load_pd(in.z + n);
+        __m256d angle = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), _mm256_mul_pd(z, z)));
+        __m256d sine, cosine;
+        approximateSinCos4(_mm256_mul_pd(_mm256_set1_pd(0.5), angle), sine, cosine);
+        __m256d factor = _mm256_blendv_pd(_mm256_set1_pd(0.5), _mm256_div_pd(sine, angle), _mm256_cmp_pd(angle, _mm256_setzero_pd(), _CMP_GT_OQ));
+
+        _mm256_store_pd(out.scalar + n, cosine);
+        _mm256_store_pd(out.i + n, _mm256_mul_pd(x, factor));
+        _mm256_store_pd(out.j + n, _mm256_mul_pd(y, factor));
+        _mm256_store_pd(out.k + n, _mm256_mul_pd(z, factor));
+    }
+#endif
+
+    for (; n < in.count; n++) {
+        double angle = sqrt(in.x[n] * in.x[n] + in.y[n] * in.y[n] + in.z[n] * in.z[n]);
+        double sine, cosine;
+        approximateSinCos(0.5 * angle, sine, cosine);
+        double factor = angle > 0.0 ? sine / angle : 0.5;
+
+        out.scalar[n] = cosine;
+        out.i[n] = in.x[n] * factor;
+        out.j[n] = in.y[n] * factor;
+        out.k[n] = in.z[n] * factor;
+    }
+}
+
+// Function to find the rotation vectors of an array of unit quaternions, each with angle at most pi
+void quaternionsToRotationVectors(const QuaternionArray& in, Vector3Array& out) {
+    checkQuaternionArraySizes(in.count, out.count);
+
+    size_t n = 0;
+
+#if defined(__AVX2__)
+    for (; n + 4 <= in.count; n += 4) {
+        __m256d s = _mm256_load_pd(in.scalar + n), x = _mm256_load_pd(in.i + n), y = _mm256_load_pd(in.j + n), z = _mm256_load_pd(in.k + n);
+        __m256d signBit = _mm256_and_pd(s, _mm256_set1_pd(-0.0));
+        __m256d vectorNorm = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), _mm256_mul_pd(z, z)));
+        __m256d angle = approximateAtan2_4(vectorNorm, _mm256_xor_pd(s, signBit));
+        __m256d factor = _mm256_div_pd(_mm256_add_pd(angle, angle), vectorNorm);
+        factor = _mm256_xor_pd(_mm256_and_pd(factor, _mm256_cmp_pd(vectorNorm, _mm256_setzero_pd(), _CMP_GT_OQ)), signBit);
+
+        _mm256_store_pd(out.x + n, _mm256_mul_pd(x, factor));
+        _mm256_store_pd(out.y + n, _mm256_mul_pd(y, factor));
+        _mm256_store_pd(out.z + n, _mm256_mul_pd(z, factor));
+    }
+#endif
+
+    for (; n < in.count; n++) {
+        double sign = in.scalar[n] < 0.0 ? -1.0 : 1.0;
+        double vectorNorm = sqrt(in.i[n] * in.i[n] + in.j[n] * in.j[n] + in.k[n] * in.k[n]);
+        double factor = vectorNorm > 0.0 ? sign * 2.0 * approximateAtan2(vectorNorm, fabs(in.scalar[n])) / vectorNorm : 0.0;
+
+        out.x[n] = in.i[n] * factor;
+        out.y[n] = in.j[n] * factor;
+        out.z[n] = in.k[n] * factor;
+    }
+}
+
+// Function to build unit quaternions from an array of unit axes and their angles in radians
+void axisAnglesToQuaternions(const Vector3Array& axes, const double* angles, QuaternionArray& out) {
+    checkQuaternionArraySizes(axes.count, out.count);
+
+    size_t n = 0;
+
+#if defined(__AVX2__)
+    for (; n + 4 <= axes.count; n += 4) {
+        __m256d sine, cosine;
+        approximateSinCos4(_mm256_mul_pd(_mm256_set1_pd(0.5), _mm256_loadu_pd(angles + n)), sine, cosine);
+
+        _mm256_store_pd(out.scalar + n, cosine);
+        _mm256_store_pd(out.i + n, _mm256_mul_pd(_mm256_load_pd(axes.x + n), sine));
+        _mm256_store_pd(out.j + n, _mm256_mul_pd(_mm256_load_pd(axes.y + n), sine));
+        _mm256_store_pd(out.k + n, _mm256_mul_pd(_mm256_load_pd(axes.z + n), sine));
+    }
+#endif
+
+    for (; n < axes.count; n++) {
+        double sine, cosine;
+        approximateSinCos(0.5 * angles[n], sine, cosine);
+
+        out.scalar[n] = cosine;
+        out.i[n] = axes.x[n] * sine;
+        out.j[n] = axes.y[n] * sine;
+        out.k[n] = axes.z[n] * sine;
+    }
+}
+
+// Function to split an array of unit quaternions into unit axes and angles in [0, pi]; the identity gives the x axis
+void quaternionsToAxisAngles(const QuaternionArray& in, Vector3Array& axes, double* angles) {
+    checkQuaternionArraySizes(in.count, axes.count);
+
+    size_t n = 0;
+
+#if defined(__AVX2__)
+    for (; n + 4 <= in.count; n += 4) {
+        __m256d s = _mm256_load_pd(in.scalar + n), x = _mm256_load_pd(in.i + n), y = _mm256_load_pd(in.j + n), z = _mm256_load_pd(in.k + n);
+        __m256d signBit = _mm256_and_pd(s, _mm256_set1_pd(-0.0));
+        __m256d vectorNorm = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), _mm256_mul_pd(z, z)));
+        __m256d rotating = _mm256_cmp_pd(vectorNorm, _mm256_setzero_pd(), _CMP_GT_OQ);
+        __m256d factor = _mm256_xor_pd(_mm256_and_pd(_mm256_div_pd(_mm256_set1_pd(1.0), vectorNorm), rotating), signBit);
+        __m256d angle = approximateAtan2_4(vectorNorm, _mm256_xor_pd(s, signBit));
+
+        _mm256_store_pd(axes.x + n, _mm256_blendv_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(x, factor), rotating));
+        _mm256_store_pd(axes.y + n, _mm256_mul_pd(y, factor));
+        _mm256_store_pd(axes.z + n, _mm256_mul_pd(z, factor));
+        _mm256_storeu_pd(angles + n, _mm256_add_pd(angle, angle));
+    }
+#endif
+
+    for (; n < in.count; n++) {
+        double sign = in.scalar[n] < 0.0 ? -1.0 : 1.0;
+        double vectorNorm = sqrt(in.i[n] * in.i[n] + in.j[n] * in.j[n] + in.k[n] * in.k[n]);
+        double factor = vectorNorm > 0.0 ? sign / vectorNorm : 0.0;
+
+        axes.x[n] = vectorNorm > 0.0 ? in.i[n] * factor : 1.0;
+        axes.y[n] = in.j[n] * factor;
+        axes.z[n] = in.k[n] * factor;
+        angles[n] = 2.0 * approximateAtan2(vectorNorm, fabs(in.scalar[n]));
+    }
+}
+
+// Function to rotate a vector by a unit quaternion (w, u) without forming q v q^-1:
+// t = 2 (u x v), v' = v + w t + u x t, which equals v + 2w (u x v) + 2u x (u x v)
+inline void rotateVectorComponents(double w, double x, double y, double z, double& vx, double& vy, double& vz) {
+    double tx = 2.0 * (y * vz - z * vy);
+    double ty = 2.0 * (z * vx - x * vz);
+    double tz = 2.0 * (x * vy - y * vx);
+
+    double rx = vx + w * tx + (y * tz - z * ty);
+    double ry = vy + w * ty + (z * tx - x * tz);
+    double rz = vz + w * tz + (x * ty - y * tx);
+
+    vx = rx;
+    vy = ry;
+    vz = rz;
+}
+
+#if defined(__AVX__)
+// Function to rotate four vectors by four unit quaternions, one per lane, with the same formula
+inline void rotateVectors4(__m256d w, __m256d x, __m256d y, __m256d z, __m256d& vx, __m256d& vy, __m256d& vz) {
+    const __m256d two = _mm256_set1_pd(2.0);
+
+    __m256d tx = _mm256_mul_pd(two, _mm256_sub_pd(_mm256_mul_pd(y, vz), _mm256_mul_pd(z, vy)));
+    __m256d ty = _mm256_mul_pd(two, _mm256_sub_pd(_mm256_mul_pd(z, vx), _mm256_mul_pd(x, vz)));
+    __m256d tz = _mm256_mul_pd(two, _mm256_sub_pd(_mm256_mul_pd(x, vy), _mm256_mul_pd(y, vx)));
+
+    vx = _mm256_add_pd(_mm256_add_pd(vx, _mm256_mul_pd(w, tx)), _mm256_sub_pd(_mm256_mul_pd(y, tz), _mm256_mul_pd(z, ty)));
+    vy = _mm256_add_pd(_mm256_add_pd(vy, _mm256_mul_pd(w, ty)), _mm256_sub_pd(_mm256_mul_pd(z, tx), _mm256_mul_pd(x, tz)));
+    vz = _mm256_add_pd(_mm256_add_pd(vz, _mm256_mul_pd(w, tz)), _mm256_sub_pd(_mm256_mul_pd(x, ty), _mm256_mul_pd(y, tx)));
+}
+#endif
+
+// Function to rotate a vector by a unit quaternion
+Vector3 rotateVector(const Quaternion& rotation, const Vector3& vector) {
+    Vector3 result = vector;
+    rotateVectorComponents(rotation.scalar, rotation.i, rotation.j, rotation.k, result.x, result.y, result.z);
+    return result;
+}
+
+// Function to rotate vectors [begin, end) of an array by one unit quaternion
+void rotateVectorRange(const Quaternion& rotation, const Vector3Array& in, Vector3Array& out, size_t begin, size_t end) {
+    size_t n = begin;
+
+#if defined(__AVX__)
+    __m256d w = _mm256_set1_pd(rotation.scalar), x = _mm256_set1_pd(rotation.i), y = _mm256_set1_pd(rotation.j), z = _mm256_set1_pd(rotation.k);
+
+    for (; n + 4 <= end; n += 4) {
+        __m256d vx = _mm256_loadu_pd(in.x + n), vy = _mm256_loadu_pd(in.y + n), vz = _mm256_loadu_pd(in.z + n);
+        rotateVectors4(w, x, y, z, vx, vy, vz);
+
+        _mm256_storeu_pd(out.x + n, vx);
+        _mm256_storeu_pd(out.y + n, vy);
+        _mm256_storeu_pd(out.z + n, vz);
+    }
+#endif
+
+    for (; n < end; n++) {
+        double vx = in.x[n], vy = in.y[n], vz = in.z[n];
+        rotateVectorComponents(rotation.scalar, rotation.i, rotation.j, rotation.k, vx, vy, vz);
+
+        out.x[n] = vx;
+        out.y[n] = vy;
+        out.z[n] = vz;
+    }
+}
+
+// Function to rotate vectors [begin, end) of an array each by the unit quaternion at the same index
+void rotateVectorRange(const QuaternionArray& rotations, const Vector3Array& in, Vector3Array& out, size_t begin, size_t end) {
+    size_t n = begin;
+
+#if defined(__AVX__)
+    for (; n + 4 <= end; n += 4) {
+        __m256d w = _mm256_loadu_pd(rotations.scalar + n), x = _mm256_loadu_pd(rotations.i + n);
+        __m256d y = _mm256_loadu_pd(rotations.j + n), z = _mm256_loadu_pd(rotations.k + n);
+        __m256d vx = _mm256_loadu_pd(in.x + n), vy = _mm256_loadu_pd(in.y + n), vz = _mm256_loadu_pd(in.z + n);
+        rotateVectors4(w, x, y, z, vx, vy, vz);
+
+        _mm256_storeu_pd(out.x + n, vx);
+        _mm256_storeu_pd(out.y + n, vy);
+        _mm256_storeu_pd(out.z + n, vz);
+    }
+#endif
+
+    for (; n < end; n++) {
+        double vx = in.x[n], vy = in.y[n], vz = in.z[n];
+        rotateVectorComponents(rotations.scalar[n], rotations.i[n], rotations.j[n], rotations.k[n], vx, vy, vz);
+
+        out.x[n] = vx;
+        out.y[n] = vy;
+        out.z[n] = vz;
+    }
+}
+
+// Function to rotate every vector of an array by one unit quaternion, across threads; out may be the input
+void rotateVectorArray(const Quaternion& rotation, const Vector3Array& in, Vector3Array& out) {
+    checkQuaternionArraySizes(in.count, out.count);
+
+    ParallelCore::runInParallel(in.count, chooseThreadCount(in.count), [&](int, size_t begin, size_t end) {
+        rotateVectorRange(rotation, in, out, begin, end);
+    });
+}
+
+// Function to rotate every vector of an array by the unit quaternion at the same index, across threads;
+// out may be the input
+void rotateVectorArrays(const QuaternionArray& rotations, const Vector3Array& in, Vector3Array& out) {
+    checkQuaternionArraySizes(rotations.count, in.count);
+    checkQuaternionArraySizes(in.count, out.count);
+
+    ParallelCore::runInParallel(in.count, chooseThreadCount(in.count), [&](int, size_t begin, size_t end) {
+        rotateVectorRange(rotations, in, out, begin, end);
+    });
+}
+
+// Structure to represent a rigid transform as a unit dual quaternion real + e dual. real is the rotation and
+// dual = t real / 2 carries the translation t; a point is rotated first, then translated.
+struct DualQuaternion {
+    Quaternion real;
+    Quaternion dual;
+
+    DualQuaternion(const Quaternion& real = Quaternion(1.0), const Quaternion& dual = Quaternion())
+        : real(real), dual(dual) {}
+};
+
+// Structure to hold many dual quaternions as two quaternion arrays, so every component is its own array
+struct DualQuaternionArray {
+    size_t count = 0;
+    QuaternionArray real;
+    QuaternionArray dual;
+
+    DualQuaternionArray() {}
+
+    explicit DualQuaternionArray(size_t n)
+        : count(n), real(n), dual(n) {}
+
+    DualQuaternion get(size_t index) const {
+        return DualQuaternion(real.get(index), dual.get(index));
+    }
+
+    void set(size_t index, const DualQuaternion& transform) {
+        real.set(index, transform.real);
+        dual.set(index, transform.dual);
+    }
+};
+
+// Function to build the dual quaternion that rotates by a unit quaternion and then translates
+DualQuaternion createDualQuaternion(const Quaternion& rotation, const Vector3& translation) {
+    Quaternion dual = multiplyByScalar(multiplyQuaternions(Quaternion(0.0, translation.x, translation.y, translation.z), rotation), 0.5);
+    return DualQuaternion(rotation, dual);
+}
+
+// Function to multiply two dual quaternions; the result applies b first, then a
+DualQuaternion multiplyDualQuaternions(const DualQuaternion& a, const DualQuaternion& b) {
+    return DualQuaternion(multiplyQuaternions(a.real, b.real),
+        addQuaternions(multiplyQuaternions(a.real, b.dual), multiplyQuaternions(a.dual, b.real)));
+}
+
+// Function to calculate the inverse of a unit dual quaternion, which conjugates both parts
+DualQuaternion calculateUnitDualQuaternionInverse(const DualQuaternion& transform) {
+    return DualQuaternion(calculateConjugate(transform.real), calculateConjugate(transform.dual));
+}
+
+// Function to scale a dual quaternion to unit length: divide by |real|, then remove the part of dual along
+// real so that real . dual = 0 again. The real part must not be zero.
+DualQuaternion normalizeDualQuaternion(const DualQuaternion& transform) {
+    double factor = 1.0 / sqrt(calculateDotProduct(transform.real, transform.real));
+    Quaternion real = multiplyByScalar(transform.real, factor);
+    Quaternion dual = multiplyByScalar(transform.dual, factor);
+
+    return DualQuaternion(real, subtractQuaternions(dual, multiplyByScalar(real, calculateDotProduct(real, dual))));
+}
+
+// Function to find the translation of a unit dual quaternion, the vector part of 2 dual real*
+Vector3 dualQuaternionTranslation(const DualQuaternion& transform) {
+    Quaternion translation = multiplyQuaternions(transform.dual, calculateConjugate(transform.real));
+    return Vector3(2.0 * translation.i, 2.0 * translation.j, 2.0 * translation.k);
+}
+
+// Function to apply the translation t = 2 (w d - s u + u x d) of a unit dual quaternion with
+// real part (w, u) and dual part (s, d) to a point
+inline void translateByDualComponents(double w, double x, double y, double z, double s, double dx, double dy, double dz,
+    double& vx, double& vy, double& vz) {
+    vx += 2.0 * (w * dx - s * x + (y * dz - z * dy));
+    vy += 2.0 * (w * dy - s * y + (z * dx - x * dz));
+    vz += 2.0 * (w * dz - s * z + (x * dy - y * dx));
+}
+
+// Function to transform a point by a unit dual quaternion
+Vector3 transformPoint(const DualQuaternion& transform, const Vector3& point) {
+    const Quaternion& r = transform.real;
+    const Quaternion& d = transform.dual;
+    Vector3 result = rotateVector(r, point);
+
+    translateByDualComponents(r.scalar, r.i, r.j, r.k, d.scalar, d.i, d.j, d.k, result.x, result.y, result.z);
+    return result;
+}
+
+// Function to write a unit dual quaternion as a row-major 4x4 homogeneous matrix
+void dualQuaternionToMatrix(const DualQuaternion& transform, double* matrix) {
+    double w = transform.real.scalar, x = transform.real.i, y = transform.real.j, z = transform.real.k;
+    Vector3 translation = dualQuaternionTranslation(transform);
+
+    matrix[0] = 1 - 2 * y * y - 2 * z * z;
+    matrix[1] = 2 * x * y - 2 * w * z;
+    matrix[2] = 2 * x * z + 2 * w * y;
+    matrix[3] = translation.x;
+    matrix[4] = 2 * x * y + 2 * w * z;
+    matrix[5] = 1 - 2 * x * x - 2 * z * z;
+    matrix[6] = 2 * y * z - 2 * w * x;
+    matrix[7] = translation.y;
+    matrix[8] = 2 * x * z - 2 * w * y;
+    matrix[9] = 2 * y * z + 2 * w * x;
+    matrix[10] = 1 - 2 * x * x - 2 * y * y;
+    matrix[11] = translation.z;
+    matrix[12] = 0.0;
+    matrix[13] = 0.0;
+    matrix[14] = 0.0;
+    matrix[15] = 1.0;
+}
+
+// Function to blend two unit dual quaternions linearly and renormalize (DLB). b is negated when its rotation
+// is in the other hemisphere, so the blend takes the shorter path.
+DualQuaternion blendDualQuaternions(const DualQuaternion& a, const DualQuaternion& b, double t) {
+    double weightB = calculateDotProduct(a.real, b.real) < 0.0 ? -t : t;
+    Quaternion real = addQuaternions(multiplyByScalar(a.real, 1.0 - t), multiplyByScalar(b.real, weightB));
+    Quaternion dual = addQuaternions(multiplyByScalar(a.dual, 1.0 - t), multiplyByScalar(b.dual, weightB));
+
+    return normalizeDualQuaternion(DualQuaternion(real, dual));
+}
+
+// Function to interpolate between two unit dual quaternions along the screw motion joining them (ScLERP),
+// a (a* b)^t. The relative transform is split into its screw parameters: half angle h about the unit axis l,
+// pitch p along it and moment m, which are scaled by t and recombined.
+DualQuaternion sclerpDualQuaternions(const DualQuaternion& a, const DualQuaternion& b, double t) {
+    DualQuaternion target = calculateDotProduct(a.real, b.real) < 0.0 ?
+        DualQuaternion(multiplyByScalar(b.real, -1.0), multiplyByScalar(b.dual, -1.0)) : b;
+    DualQuaternion relative = multiplyDualQuaternions(calculateUnitDualQuaternionInverse(a), target);
+
+    const Quaternion& r = relative.real;
+    const Quaternion& d = relative.dual;
+    double vectorNorm = sqrt(r.i * r.i + r.j * r.j + r.k * r.k);
+
+    if (vectorNorm < 1e-12) {
+        // No rotation between them: the relative transform is a pure translation, which scales linearly
+        return multiplyDualQuaternions(a, DualQuaternion(Quaternion(1.0), multiplyByScalar(Quaternion(0.0, d.i, d.j, d.k), t)));
+    }
+
+    double halfAngle = atan2(vectorNorm, r.scalar);
+    Vector3 axis(r.i / vectorNorm, r.j / vectorNorm, r.k / vectorNorm);
+    double pitch = -2.0 * d.scalar / vectorNorm;
+    double halfPitchCos = 0.5 * pitch * r.scalar;
+    Vector3 moment((d.i - axis.x * halfPitchCos) / vectorNorm, (d.j - axis.y * halfPitchCos) / vectorNorm,
+        (d.k - axis.z * halfPitchCos) / vectorNorm);
+
+    double sine = sin(t * halfAngle);
+    double cosine = cos(t * halfAngle);
+    double halfPitch = 0.5 * t * pitch;
+
+    Quaternion real(cosine, axis.x * sine, axis.y * sine, axis.z * sine);
+    Quaternion dual(-halfPitch * sine, axis.x * halfPitch * cosine + moment.x * sine,
+        axis.y * halfPitch * cosine + moment.y * sine, axis.z * halfPitch * cosine + moment.z * sine);
+
+    return multiplyDualQuaternions(a, DualQuaternion(real, dual));
+}
+
+// Function to check that two dual quaternion arrays can be combined elementwise
+void checkDualQuaternionArraySizes(size_t a, size_t b) {
+    if (a != b) {
+        cerr << "Error: Dual quaternion arrays have different lengths." << endl;
+        exit(1);
+    }
+}
+
+#if defined(__AVX__)
+// Function to multiply four pairs of quaternions, one pair per lane
+inline void multiplyQuaternions4(__m256d as, __m256d ai, __m256d aj, __m256d ak, __m256d bs, __m256d bi, __m256d bj, __m256d bk,
+    __m256d& s, __m256d& x, __m256d& y, __m256d& z) {
+    s = _mm256_sub_pd(_mm256_sub_pd(_mm256_sub_pd(_mm256_mul_pd(as, bs), _mm256_mul_pd(ai, bi)), _mm256_mul_pd(aj, bj)), _mm256_mul_pd(ak, bk));
+    x = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(as, bi), _mm256_mul_pd(ai, bs)), _mm256_mul_pd(aj, bk)), _mm256_mul_pd(ak, bj));
+    y = _mm256_add_pd(_mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(as, bj), _mm256_mul_pd(ai, bk)), _mm256_mul_pd(aj, bs)), _mm256_mul_pd(ak, bi));
+    z = _mm256_add_pd(_mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(as, bk), _mm256_mul_pd(ai, bj)), _mm256_mul_pd(aj, bi)), _mm256_mul_pd(ak, bs));
+}
+
+// Function to calculate four dot products of quaternions, one per lane
+inline __m256d dotProduct4(__m256d as, __m256d ai, __m256d aj, __m256d ak, __m256d bs, __m256d bi, __m256d bj, __m256d bk) {
+    return _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(as, bs), _mm256_mul_pd(ai, bi)), _mm256_add_pd(_mm256_mul_pd(aj, bj), _mm256_mul_pd(ak, bk)));
+}
+
+// Function to normalize four dual quaternions held lane by lane, as normalizeDualQuaternion does
+inline void normalizeDualQuaternions4(__m256d* real, __m256d* dual) {
+    __m256d factor = _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(dotProduct4(real[0], real[1], real[2], real[3], real[0], real[1], real[2], real[3])));
+
+    for (int c = 0; c < 4; c++) {
+        real[c] = _mm256_mul_pd(real[c], factor);
+        dual[c] = _mm256_mul_pd(dual[c], factor);
+    }
+
+    __m256d along = dotProduct4(real[0], real[1], real[2], real[3], dual[0], dual[1], dual[2], dual[3]);
+
+    for (int c = 0; c < 4; c++) {
+        dual[c] = _mm256_sub_pd(dual[c], _mm256_mul_pd(real[c], along));
+    }
+}
+
+// Function to load four quaternions of an array starting at index n into lane registers
+inline void loadQuaternions4(const QuaternionArray& array, size_t n, __m256d* lanes) {
+    lanes[0] = _mm256_loadu_pd(array.scalar + n);
+    lanes[1] = _mm256_loadu_pd(array.i + n);
+    lanes[2] = _mm256_loadu_pd(array.j + n);
+    lanes[3] = _mm256_loadu_pd(array.k + n);
+}
+
+// Function to store four quaternions held in lane registers into an array starting at index n
+inline void storeQuaternions4(QuaternionArray& array, size_t n, const __m256d* lanes) {
+    _mm256_storeu_pd(array.scalar + n, lanes[0]);
+    _mm256_storeu_pd(array.i + n, lanes[1]);
+    _mm256_storeu_pd(array.j + n, lanes[2]);
+    _mm256_storeu_pd(array.k + n, lanes[3]);
+}
+#endif
+
+// Function to multiply two dual quaternion arrays elementwise; out may be either input
+void multiplyDualQuaternionArrays(const DualQuaternionArray& a, const DualQuaternionArray& b, DualQuaternionArray& out) {
+    checkDualQuaternionArraySizes(a.count, b.count);
+    checkDualQuaternionArraySizes(a.count, out.count);
+
+    size_t n = 0;
+
+#if defined(__AVX__)
+    for (; n + 4 <= a.count; n += 4) {
+        __m256d ar[4], ad[4], br[4], bd[4], real[4], dual[4], cross[4];
+        loadQuaternions4(a.real, n, ar);
+        loadQuaternions4(a.dual, n, ad);
+        loadQuaternions4(b.real, n, br);
+        loadQuaternions4(b.dual, n, bd);
+
+        multiplyQuaternions4(ar[0], ar[1], ar[2], ar[3], br[0], br[1], br[2], br[3], real[0], real[1], real[2], real[3]);
+        multiplyQuaternions4(ar[0], ar[1], ar[2], ar[3], bd[0], bd[1], bd[2], bd[3], dual[0], dual[1], dual[2], dual[3]);
+        multiplyQuaternions4(ad[0], ad[1], ad[2], ad[3], br[0], br[1], br[2], br[3], cross[0], cross[1], cross[2], cross[3]);
+
+        for (int c = 0; c < 4; c++) {
+            dual[c] = _mm256_add_pd(dual[c], cross[c]);
+        }
+
+        storeQuaternions4(out.real, n, real);
+        storeQuaternions4(out.dual, n, dual);
+    }
+#endif
+
+    for (; n < a.count; n++) {
+        out.set(n, multiplyDualQuaternions(a.get(n), b.get(n)));
+    }
+}
+
+// Function to normalize every dual quaternion of an array; out may be the input
+void normalizeDualQuaternionArray(const DualQuaternionArray& in, DualQuaternionArray& out) {
+    checkDualQuaternionArraySizes(in.count, out.count);
+
+    size_t n = 0;
+
+#if defined(__AVX__)
+    for (; n + 4 <= in.count; n += 4) {
+        __m256d real[4], dual[4];
+        loadQuaternions4(in.real, n, real);
+        loadQuaternions4(in.dual, n, dual);
+
+        normalizeDualQuaternions4(real, dual);
+
+        storeQuaternions4(out.real, n, real);
+        storeQuaternions4(out.dual, n, dual);
+    }
+#endif
+
+    for (; n < in.count; n++) {
+        out.set(n, normalizeDualQuaternion(in.get(n)));
+    }
+}
+
+// Function to blend two unit dual quaternion arrays elementwise with the same weight t (DLB); out may be either input
+void blendDualQuaternionArrays(const DualQuaternionArray& a, const DualQuaternionArray& b, double t, DualQuaternionArray& out) {
+    checkDualQuaternionArraySizes(a.count, b.count);
+    checkDualQuaternionArraySizes(a.count, out.count);
+
+    size_t n = 0;
+
+#if defined(__AVX__)
+    const __m256d weightA = _mm256_set1_pd(1.0 - t);
+
+    for (; n + 4 <= a.count; n += 4) {
+        __m256d ar[4], ad[4], br[4], bd[4];
+        loadQuaternions4(a.real, n, ar);
+        loadQuaternions4(a.dual, n, ad);
+        loadQuaternions4(b.real, n, br);
+        loadQuaternions4(b.dual, n, bd);
+
+        // Copy the sign of a.real . b.real onto t to flip b into a's hemisphere
+        __m256d signBit = _mm256_and_pd(dotProduct4(ar[0], ar[1], ar[2], ar[3], br[0], br[1], br[2], br[3]), _mm256_set1_pd(-0.0));
+        __m256d weightB = _mm256_xor_pd(_mm256_set1_pd(t), signBit);
+
+        for (int c = 0; c < 4; c++) {
+            ar[c] = _mm256_add_pd(_mm256_mul_pd(ar[c], weightA), _mm256_mul_pd(br[c], weightB));
+            ad[c] = _mm256_add_pd(_mm256_mul_pd(ad[c], weightA), _mm256_mul_pd(bd[c], weightB));
+        }
+
+        normalizeDualQuaternions4(ar, ad);
+
+        storeQuaternions4(out.real, n, ar);
+        storeQuaternions4(out.dual, n, ad);
+    }
+#endif
+
+    for (; n < a.count; n++) {
+        out.set(n, blendDualQuaternions(a.get(n), b.get(n), t));
+    }
+}
+
+// Function to interpolate two unit dual quaternion arrays elementwise along their screw motions (ScLERP).
+// Each element needs its own atan2, sin and cos, so this loops over sclerpDualQuaternions; use
+// blendDualQuaternionArrays where the small error of DLB is acceptable.
+void sclerpDualQuaternionArrays(const DualQuaternionArray& a, const DualQuaternionArray& b, double t, DualQuaternionArray& out) {
+    checkDualQuaternionArraySizes(a.count, b.count);
+    checkDualQuaternionArraySizes(a.count, out.count);
+
+    for (size_t n = 0; n < a.count; n++) {
+        out.set(n, sclerpDualQuaternions(a.get(n), b.get(n), t));
+    }
+}
+
+// Function to transform points [begin, end) of an array each by the unit dual quaternion at the same index
+void transformPointRange(const DualQuaternionArray& transforms, const Vector3Array& in, Vector3Array& out, size_t begin, size_t end) {
+    size_t n = begin;
+
+#if defined(__AVX__)
+    const __m256d two = _mm256_set1_pd(2.0);
+
+    for (; n + 4 <= end; n += 4) {
+        __m256d r[4], d[4];
+        loadQuaternions4(transforms.real, n, r);
+        loadQuaternions4(transforms.dual, n, d);
+        __m256d vx = _mm256_loadu_pd(in.x + n), vy = _mm256_loadu_pd(in.y + n), vz = _mm256_loadu_pd(in.z + n);
+
+        rotateVectors4(r[0], r[1], r[2], r[3], vx, vy, vz);
+
+        __m256d tx = _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(r[0], d[1]), _mm256_mul_pd(d[0], r[1])), _mm256_sub_pd(_mm256_mul_pd(r[2], d[3]), _mm256_mul_pd(r[3], d[2])));
+        __m256d ty = _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(r[0], d[2]), _mm256_mul_pd(d[0], r[2])), _mm256_sub_pd(_mm256_mul_pd(r[3], d[1]), _mm256_mul_pd(r[1], d[3])));
+        __m256d tz = _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(r[0], d[3]), _mm256_mul_pd(d[0], r[3])), _mm256_sub_pd(_mm256_mul_pd(r[1], d[2]), _mm256_mul_pd(r[2], d[1])));
+
+        _mm256_storeu_pd(out.x + n, _mm256_add_pd(vx, _mm256_mul_pd(two, tx)));
+        _mm256_storeu_pd(out.y + n, _mm256_add_pd(vy, _mm256_mul_pd(two, ty)));
+        _mm256_storeu_pd(out.z + n, _mm256_add_pd(vz, _mm256_mul_pd(two, tz)));
+    }
+#endif
+
+    for (; n < end; n++) {
+        double vx = in.x[n], vy = in.y[n], vz = in.z[n];
+        double w = transforms.real.scalar[n], x = transforms.real.i[n], y = transforms.real.j[n], z = transforms.real.k[n];
+
+        rotateVectorComponents(w, x, y, z, vx, vy, vz);
+        translateByDualComponents(w, x, y, z, transforms.dual.scalar[n], transforms.dual.i[n], transforms.dual.j[n], transforms.dual.k[n], vx, vy, vz);
+
+        out.x[n] = vx;
+        out.y[n] = vy;
+        out.z[n] = vz;
+    }
+}
+
+// Function to transform every point of an array by one unit dual quaternion, across threads; out may be the input
+void transformPointArray(const DualQuaternion& transform, const Vector3Array& in, Vector3Array& out) {
+    checkQuaternionArraySizes(in.count, out.count);
+
+    // A rotation followed by a fixed translation: rotate with the batched kernel, then add the translation
+    Vector3 translation = dualQuaternionTranslation(transform);
+
+    ParallelCore::runInParallel(in.count, chooseThreadCount(in.count), [&](int, size_t begin, size_t end) {
+        rotateVectorRange(transform.real, in, out, begin, end);
+
+        for (size_t n = begin; n < end; n++) {
+            out.x[n] += translation.x;
+            out.y[n] += translation.y;
+            out.z[n] += translation.z;
+        }
+    });
+}
+
+// Function to transform every point of an array by the unit dual quaternion at the same index, across threads;
+// out may be the input
+void transformPointArrays(const DualQuaternionArray& transforms, const Vector3Array& in, Vector3Array& out) {
+    checkDualQuaternionArraySizes(transforms.count, in.count);
+    checkQuaternionArraySizes(in.count, out.count);
+
+    ParallelCore::runInParallel(in.count, chooseThreadCount(in.count), [&](int, size_t begin, size_t end) {
+        transformPointRange(transforms, in, out, begin, end);
+    });
+}
+
+// Function to time a batched operation against looping the scalar function over the same data
+// Small counts are repeated so that every measurement covers roughly the same amount of work.
+template <typename Scalar, typename Batched>
+void benchmarkOperation(const string& name, size_t count, Scalar scalarLoop, Batched batched) {
+    size_t repeats = max<size_t>(1, 20000000 / max<size_t>(count, 1));
+
+    auto start = chrono::steady_clock::now();
+    for (size_t r = 0; r < repeats; r++) {
+        scalarLoop();
+    }
+    double scalarSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count() / repeats;
+
+    start = chrono::steady_clock::now();
+    for (size_t r = 0; r < repeats; r++) {
+        batched();
+    }
+    double batchedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count() / repeats;
+
+    cout << name << ": scalar " << scalarSeconds * 1e9 / count << " ns, batched " << batchedSeconds * 1e9 / count
+        << " ns per quaternion (" << scalarSeconds / batchedSeconds << "x)\n";
+}
+
+// Function to time steps calls of step, each taking the previous call's result, so the calls cannot overlap and
+// the time per call is its latency rather than its throughput. Returns nanoseconds per call.
+template <typename Value, typename Step>
+double measureLatency(size_t steps, Value& value, Step step) {
+    auto start = chrono::steady_clock::now();
+    for (size_t n = 0; n < steps; n++) {
+        value = step(value);
+    }
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count() * 1e9 / steps;
+}
+
+// Function to time one product and one dot product as a control loop uses them, each call taking the previous
+// call's result. A packed AVX single-quaternion kernel was measured here at about twice the latency of the scalar
+// formulas, so single quaternions stay scalar and only the batched kernels use SIMD.
+void runLatencyBenchmark(size_t steps) {
+    // A small unit rotation keeps the chained product at unit length
+    Quaternion step = normalizeQuaternion(Quaternion(1.0, 0.001, -0.002, 0.003));
+    Quaternion other(0.5, 0.25, -0.125, 0.0625);
+
+    Quaternion product(1.0);
+    double productTime = measureLatency(steps, product, [&](const Quaternion& q) { return multiplyQuaternions(q, step); });
+
+    // The previous dot product becomes the next scalar component; |other| < 1 keeps the chain bounded
+    double dot = 1.0;
+    double dotTime = measureLatency(steps, dot, [&](double d) { return calculateDotProduct(Quaternion(d, 0.5, 0.25, 0.125), other); });
+
+    cout << "Latency over " << steps << " dependent calls: multiply " << productTime << " ns, dot " << dotTime
+        << " ns (final |product| " << sqrt(calculateDotProduct(product, product)) << ", dot " << dot << ")\n";
+}
+
+// Function to benchmark the batched quaternion functions against looping the scalar functions
+void runQuaternionBenchmark(size_t count) {
+    vector<Quaternion> scalarA(count), scalarB(count), scalarOut(count);
+    vector<double> scalarDots(count), batchedDots(count);
+    QuaternionArray a(count), b(count), out(count);
+
+    mt19937_64 generator(42);
+    uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+    for (size_t n = 0; n < count; n++) {
+        scalarA[n] = Quaternion(distribution(generator), distribution(generator), distribution(generator), distribution(generator));
+        scalarB[n] = Quaternion(distribution(generator), distribution(generator), distribution(generator), distribution(generator));
+        a.set(n, scalarA[n]);
+        b.set(n, scalarB[n]);
+    }
+
+    cout << "Benchmark over " << count << " quaternions:\n";
+
+    benchmarkOperation("add", count,
+        [&] { for (size_t n = 0; n < count; n++) scalarOut[n] = addQuaternions(scalarA[n], scalarB[n]); },
+        [&] { addQuaternionArrays(a, b, out); });
+
+    benchmarkOperation("subtract", count,
+        [&] { for (size_t n = 0; n < count; n++) scalarOut[n] = subtractQuaternions(scalarA[n], scalarB[n]); },
+        [&] { subtractQuaternionArrays(a, b, out); });
+
+    benchmarkOperation("multiply", count,
+        [&] { for (size_t n = 0; n < count; n++) scalarOut[n] = multiplyQuaternions(scalarA[n], scalarB[n]); },
+        [&] { multiplyQuaternionArrays(a, b, out); });
+
+    benchmarkOperation("conjugate", count,
+        [&] { for (size_t n = 0; n < count; n++) scalarOut[n] = calculateConjugate(scalarA[n]); },
+        [&] { conjugateQuaternionArray(a, out); });
+
+    benchmarkOperation("inverse", count,
+        [&] { for (size_t n = 0; n < count; n++) scalarOut[n] = calculateInverse(scalarA[n]); },
+        [&] { inverseQuaternionArray(a, out); });
+
+    benchmarkOperation("dot", count,
+        [&] { for (size_t n = 0; n < count; n++) scalarDots[n] = calculateDotProduct(scalarA[n], scalarB[n]); },
+        [&] { dotProductQuaternionArrays(a, b, batchedDots.data()); });
+
+    benchmarkOperation("scale", count,
+        [&] { for (size_t n = 0; n < count; n++) scalarOut[n] = multiplyByScalar(scalarA[n], 2.0); },
+        [&] { scaleQuaternionArray(a, 2.0, out); });
+
+    benchmarkOperation("normalize (exact vs fast)", count,
+        [&] { normalizeQuaternionArray(a, out); },
+        [&] { normalizeQuaternionArrayFast(a, out); });
+
+    normalizeQuaternionArray(a, out);
+    double exactError = largestUnitNormError(out);
+    normalizeQuaternionArrayFast(a, out);
+    double fastError = largestUnitNormError(out);
+    cout << "Largest |norm - 1| after normalize: exact " << exactError << ", fast " << fastError << "\n";
+
+    // Unit inputs: the general inverse against the conjugate shortcut
+    QuaternionArray unit(count);
+    normalizeQuaternionArray(a, unit);
+
+    benchmarkOperation("unit inverse (general vs conjugate)", count,
+        [&] { inverseQuaternionArray(unit, out); },
+        [&] { unitInverseQuaternionArray(unit, out); });
+
+    benchmarkOperation("exp", count,
+        [&] { for (size_t n = 0; n < count; n++) scalarOut[n] = exponentialQuaternion(scalarA[n]); },
+        [&] { exponentialQuaternionArray(a, out); });
+
+    benchmarkOperation("log", count,
+        [&] { for (size_t n = 0; n < count; n++) scalarOut[n] = logarithmQuaternion(scalarA[n]); },
+        [&] { logarithmQuaternionArray(a, out); });
+
+    benchmarkOperation("pow", count,
+        [&] { for (size_t n = 0; n < count; n++) scalarOut[n] = powerQuaternion(scalarA[n], 0.5); },
+        [&] { powerQuaternionArray(a, 0.5, out); });
+
+    Vector3Array rotations(count);
+    vector<Vector3> scalarRotations(count);
+
+    benchmarkOperation("to rotation vector", count,
+        [&] { for (size_t n = 0; n < count; n++) scalarRotations[n] = quaternionToRotationVector(unit.get(n)); },
+        [&] { quaternionsToRotationVectors(unit, rotations); });
+
+    benchmarkOperation("from rotation vector", count,
+        [&] { for (size_t n = 0; n < count; n++) scalarOut[n] = rotationVectorToQuaternion(scalarRotations[n]); },
+        [&] { rotationVectorsToQuaternions(rotations, out); });
+
+    // Rotating points: the sandwich product q v q* through multiplyQuaternions against the batched form
+    Vector3Array points(count), rotated(count);
+    vector<Vector3> scalarPoints(count), scalarRotated(count);
+
+    for (size_t n = 0; n < count; n++) {
+        scalarPoints[n] = Vector3(distribution(generator), distribution(generator), distribution(generator));
+        points.set(n, scalarPoints[n]);
+    }
+
+    Quaternion rotation = unit.get(0);
+
+    benchmarkOperation("rotate by one quaternion (q v q* vs batched)", count,
+        [&] {
+            for (size_t n = 0; n < count; n++) {
+                Quaternion product = multiplyQuaternions(multiplyQuaternions(rotation, Quaternion(0.0, scalarPoints[n].x, scalarPoints[n].y, scalarPoints[n].z)),
+                    calculateConjugate(rotation));
+                scalarRotated[n] = Vector3(product.i, product.j, product.k);
+            }
+        },
+        [&] { rotateVectorArray(rotation, points, rotated); });
+
+    double rotateError = 0.0;
+
+    for (size_t n = 0; n < count; n++) {
+        rotateError = max(rotateError, fabs(scalarRotated[n].x - rotated.x[n]) + fabs(scalarRotated[n].y - rotated.y[n]) + fabs(scalarRotated[n].z - rotated.z[n]));
+    }
+
+    benchmarkOperation("rotate by many quaternions (q v q* vs batched)", count,
+        [&] {
+            for (size_t n = 0; n < count; n++) {
+                Quaternion q = unit.get(n);
+                Quaternion product = multiplyQuaternions(multiplyQuaternions(q, Quaternion(0.0, scalarPoints[n].x, scalarPoints[n].y, scalarPoints[n].z)),
+                    calculateConjugate(q));
+                scalarRotated[n] = Vector3(product.i, product.j, product.k);
+            }
+        },
+        [&] { rotateVectorArrays(unit, points, rotated); });
+
+    for (size_t n = 0; n < count; n++) {
+        rotateError = max(rotateError, fabs(scalarRotated[n].x - rotated.x[n]) + fabs(scalarRotated[n].y - rotated.y[n]) + fabs(scalarRotated[n].z - rotated.z[n]));
+    }
+
+    cout << "Largest difference between rotated points: " << rotateError << "\n";
+
+    // Accuracy of the polynomial approximations against the libm-based scalar functions
+    double expError = 0.0, logError = 0.0, rotationError = 0.0;
+    exponentialQuaternionArray(a, out);
+
+    for (size_t n = 0; n < count; n++) {
+        Quaternion expected = exponentialQuaternion(scalarA[n]);
+        expError = max(expError, sqrt(calculateDotProduct(subtractQuaternions(expected, out.get(n)), subtractQuaternions(expected, out.get(n)))) /
+            sqrt(calculateDotProduct(expected, expected)));
+    }
+
+    logarithmQuaternionArray(a, out);
+
+    for (size_t n = 0; n < count; n++) {
+        Quaternion difference = subtractQuaternions(logarithmQuaternion(scalarA[n]), out.get(n));
+        logError = max(logError, sqrt(calculateDotProduct(difference, difference)));
+    }
+
+    quaternionsToRotationVectors(unit, rotations);
+
+    for (size_t n = 0; n < count; n++) {
+        Vector3 expected = quaternionToRotationVector(unit.get(n));
+        rotationError = max(rotationError, fabs(expected.x - rotations.x[n]) + fabs(expected.y - rotations.y[n]) + fabs(expected.z - rotations.z[n]));
+    }
+
+    cout << "Largest error of the polynomial approximations: exp " << expError << " (relative), log " << logError
+        << ", rotation vector " << rotationError << "\n";
+
+    // Text: format every quaternion into one buffer, one per line, then parse them all back
+    vector<char> text(count * (QUATERNION_TEXT_SIZE + 1));
+    char* textEnd = text.data();
+
+    auto start = chrono::steady_clock::now();
+    for (size_t n = 0; n < count; n++) {
+        textEnd = formatQuaternion(textEnd, text.data() + text.size(), scalarA[n]);
+        *textEnd++ = '\n';
+    }
+    double formatSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    size_t parsed = 0;
+    start = chrono::steady_clock::now();
+    for (const char* line = text.data(); line < textEnd; parsed++) {
+        const char* lineEnd = find(line, static_cast<const char*>(textEnd), '\n');
+        if (!parseQuaternion(line, lineEnd, scalarOut[parsed])) {
+            break;
+        }
+        line = lineEnd + 1;
+    }
+    double parseSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    double textError = 0.0;
+    for (size_t n = 0; n < parsed; n++) {
+        Quaternion difference = subtractQuaternions(scalarOut[n], scalarA[n]);
+        textError = max(textError, sqrt(calculateDotProduct(difference, difference) / calculateDotProduct(scalarA[n], scalarA[n])));
+    }
+
+    cout << "Text: format " << formatSeconds * 1e9 / count << " ns, parse " << parseSeconds * 1e9 / count << " ns per quaternion ("
+        << count / (formatSeconds + parseSeconds) * 60 / 1e6 << " million round trips per minute), " << parsed << " of " << count
+        << " parsed back, largest relative error " << textError << "\n";
+
+    // Check the batched kernels against the scalar functions on the benchmark data
+    double largestError = 0.0;
+    multiplyQuaternionArrays(a, b, out);
+
+    for (size_t n = 0; n < count; n++) {
+        Quaternion expected = multiplyQuaternions(scalarA[n], scalarB[n]);
+        Quaternion actual = out.get(n);
+        largestError = max(largestError, fabs(expected.scalar - actual.scalar) + fabs(expected.i - actual.i) +
+            fabs(expected.j - actual.j) + fabs(expected.k - actual.k));
+        largestError = max(largestError, fabs(scalarDots[n] - batchedDots[n]));
+    }
+
+    cout << "Largest difference from the scalar functions: " << largestError << "\n";
+}
+
+// Function to benchmark the batched dual quaternion functions against 4x4 homogeneous matrices
+void runDualQuaternionBenchmark(size_t count) {
+    DualQuaternionArray a(count), b(count), out(count);
+    vector<double> matricesA(count * 16), matricesB(count * 16), matricesOut(count * 16);
+    Vector3Array points(count), transformed(count);
+
+    mt19937_64 generator(7);
+    uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+    auto randomTransform = [&] {
+        Quaternion rotation = normalizeQuaternion(Quaternion(distribution(generator), distribution(generator), distribution(generator), distribution(generator)));
+        return createDualQuaternion(rotation, Vector3(distribution(generator), distribution(generator), distribution(generator)));
+    };
+
+    for (size_t n = 0; n < count; n++) {
+        a.set(n, randomTransform());
+        b.set(n, randomTransform());
+        dualQuaternionToMatrix(a.get(n), &matricesA[n * 16]);
+        dualQuaternionToMatrix(b.get(n), &matricesB[n * 16]);
+        points.set(n, Vector3(distribution(generator), distribution(generator), distribution(generator)));
+    }
+
+    cout << "Dual quaternion benchmark over " << count << " transforms:\n";
+
+    benchmarkOperation("compose (4x4 matrices vs dual quaternions)", count,
+        [&] { for (size_t n = 0; n < count; n++) MatrixCore::multiplySmall<4, double>(&matricesA[n * 16], &matricesB[n * 16], &matricesOut[n * 16]); },
+        [&] { multiplyDualQuaternionArrays(a, b, out); });
+
+    double composeError = 0.0;
+    double matrix[16];
+
+    for (size_t n = 0; n < count; n++) {
+        dualQuaternionToMatrix(out.get(n), matrix);
+        for (int e = 0; e < 16; e++) {
+            composeError = max(composeError, fabs(matrix[e] - matricesOut[n * 16 + e]));
+        }
+    }
+
+    benchmarkOperation("transform points (4x4 matrices vs dual quaternions)", count,
+        [&] {
+            for (size_t n = 0; n < count; n++) {
+                const double* m = &matricesA[n * 16];
+                double x = points.x[n], y = points.y[n], z = points.z[n];
+                transformed.x[n] = m[0] * x + m[1] * y + m[2] * z + m[3];
+                transformed.y[n] = m[4] * x + m[5] * y + m[6] * z + m[7];
+                transformed.z[n] = m[8] * x + m[9] * y + m[10] * z + m[11];
+            }
+        },
+        [&] { transformPointArrays(a, points, transformed); });
+
+    double transformError = 0.0;
+
+    for (size_t n = 0; n < count; n++) {
+        Vector3 expected = transformPoint(a.get(n), points.get(n));
+        transformError = max(transformError, fabs(expected.x - transformed.x[n]) + fabs(expected.y - transformed.y[n]) + fabs(expected.z - transformed.z[n]));
+    }
+
+    benchmarkOperation("normalize", count,
+        [&] { for (size_t n = 0; n < count; n++) out.set(n, normalizeDualQuaternion(out.get(n))); },
+        [&] { normalizeDualQuaternionArray(out, out); });
+
+    benchmarkOperation("blend (DLB)", count,
+        [&] { for (size_t n = 0; n < count; n++) out.set(n, blendDualQuaternions(a.get(n), b.get(n), 0.5)); },
+        [&] { blendDualQuaternionArrays(a, b, 0.5, out); });
+
+    DualQuaternionArray screw(count);
+
+    benchmarkOperation("interpolate (ScLERP vs DLB)", count,
+        [&] { sclerpDualQuaternionArrays(a, b, 0.25, screw); },
+        [&] { blendDualQuaternionArrays(a, b, 0.25, out); });
+
+    // How far DLB moves a point from where ScLERP puts it, and how well ScLERP hits its end points
+    double blendDistance = 0.0, endpointError = 0.0;
+
+    for (size_t n = 0; n < count; n++) {
+        Vector3 exact = transformPoint(screw.get(n), points.get(n));
+        Vector3 blended = transformPoint(out.get(n), points.get(n));
+        blendDistance = max(blendDistance, sqrt((exact.x - blended.x) * (exact.x - blended.x) +
+            (exact.y - blended.y) * (exact.y - blended.y) + (exact.z - blended.z) * (exact.z - blended.z)));
+
+        Vector3 start = transformPoint(sclerpDualQuaternions(a.get(n), b.get(n), 0.0), points.get(n));
+        Vector3 end = transformPoint(sclerpDualQuaternions(a.get(n), b.get(n), 1.0), points.get(n));
+        Vector3 expectedStart = transformPoint(a.get(n), points.get(n));
+        Vector3 expectedEnd = transformPoint(b.get(n), points.get(n));
+        endpointError = max(endpointError, fabs(start.x - expectedStart.x) + fabs(start.y - expectedStart.y) + fabs(start.z - expectedStart.z));
+        endpointError = max(endpointError, fabs(end.x - expectedEnd.x) + fabs(end.y - expectedEnd.y) + fabs(end.z - expectedEnd.z));
+    }
+
+    cout << "Largest difference from matrices: compose " << composeError << ", transform " << transformError << "\n";
+    cout << "ScLERP end point error " << endpointError << ", largest DLB distance from ScLERP at t = 0.25: " << blendDistance << "\n";
+}
+
+// Largest growth of | |q|^2 - 1 | in one integration step: the polynomial sin / cos keep |delta|^2 within
+// about 1e-15 of one and the product adds a few roundings, so 16 epsilon leaves a safe margin
+const double DRIFT_PER_STEP = 16 * numeric_limits<double>::epsilon();
+
+// Function to renormalize only the quaternions whose |q|^2 is more than tolerance away from one.
+// Returns how many were renormalized and stores the largest | |q|^2 - 1 | of the ones left alone in largestDrift.
+size_t renormalizeDriftedQuaternions(QuaternionArray& quaternions, double tolerance, double& largestDrift) {
+    size_t renormalized = 0;
+    size_t n = 0;
+    largestDrift = 0.0;
+
+#if defined(__AVX__)
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFll));
+    __m256d largest = _mm256_setzero_pd();
+
+    for (; n + 4 <= quaternions.count; n += 4) {
+        __m256d lanes[4];
+        loadQuaternions4(quaternions, n, lanes);
+
+        __m256d drift = _mm256_and_pd(_mm256_sub_pd(dotProduct4(lanes[0], lanes[1], lanes[2], lanes[3], lanes[0], lanes[1], lanes[2], lanes[3]), one), absMask);
+        __m256d drifted = _mm256_cmp_pd(drift, _mm256_set1_pd(tolerance), _CMP_GT_OQ);
+        int mask = _mm256_movemask_pd(drifted);
+
+        largest = _mm256_max_pd(largest, _mm256_andnot_pd(drifted, drift));
+
+        // Usually no lane has drifted and the block is left untouched
+        if (mask != 0) {
+            __m256d factor = _mm256_blendv_pd(one, _mm256_div_pd(one, _mm256_sqrt_pd(dotProduct4(lanes[0], lanes[1], lanes[2], lanes[3], lanes[0], lanes[1], lanes[2], lanes[3]))), drifted);
+
+            for (int c = 0; c < 4; c++) {
+                lanes[c] = _mm256_mul_pd(lanes[c], factor);
+            }
+
+            storeQuaternions4(quaternions, n, lanes);
+            renormalized += (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1);
+        }
+    }
+
+    alignas(32) double lanesLargest[4];
+    _mm256_store_pd(lanesLargest, largest);
+    largestDrift = max(max(lanesLargest[0], lanesLargest[1]), max(lanesLargest[2], lanesLargest[3]));
+#endif
+
+    for (; n < quaternions.count; n++) {
+        Quaternion quaternion = quaternions.get(n);
+        double drift = fabs(calculateDotProduct(quaternion, quaternion) - 1.0);
+
+        if (drift > tolerance) {
+            quaternions.set(n, normalizeQuaternion(quaternion));
+            renormalized++;
+        } else {
+            largestDrift = max(largestDrift, drift);
+        }
+    }
+
+    return renormalized;
+}
+
+// Structure to integrate the orientations of many independent gyroscopes, one step for all of them at a time.
+// Each step turns the body-frame angular velocities w and time steps dt into delta = exp(w dt / 2) and sets
+// q = q delta, across sensors with the batched kernels. Drift is checked only when the worst-case growth
+// since the last check could have crossed the tolerance, so |q|^2 always stays within tolerance of one.
+struct OrientationIntegrator {
+    QuaternionArray orientations;
+    QuaternionArray deltas;
+    Vector3Array rotations;
+    double tolerance;
+    size_t stepsUntilCheck = 1;
+    size_t steps = 0;
+    size_t checks = 0;
+    size_t renormalized = 0;
+
+    OrientationIntegrator(size_t sensors, double driftTolerance)
+        : orientations(sensors), deltas(sensors), rotations(sensors), tolerance(driftTolerance) {
+        for (size_t n = 0; n < sensors; n++) {
+            orientations.set(n, Quaternion(1.0));
+        }
+    }
+
+    // Store the rotation vector w dt of one sensor for the next step
+    void setSample(size_t sensor, double wx, double wy, double wz, double dt) {
+        rotations.x[sensor] = wx * dt;
+        rotations.y[sensor] = wy * dt;
+        rotations.z[sensor] = wz * dt;
+    }
+
+    void step() {
+        rotationVectorsToQuaternions(rotations, deltas);
+        multiplyQuaternionArrays(orientations, deltas, orientations);
+        steps++;
+
+        if (--stepsUntilCheck == 0) {
+            double largestDrift;
+            // Renormalizing at half the tolerance leaves every sensor at least half the tolerance of headroom
+            renormalized += renormalizeDriftedQuaternions(orientations, 0.5 * tolerance, largestDrift);
+            checks++;
+
+            double headroom = (tolerance - largestDrift) / DRIFT_PER_STEP;
+            stepsUntilCheck = headroom >= 1.0 ? static_cast<size_t>(min(headroom, 1e9)) : 1;
+        }
+    }
+};
+
+// Structure to read whitespace-separated numbers from a stream in large blocks, parsing them with from_chars
+struct NumberReader {
+    istream& input;
+    vector<char> buffer;
+    size_t position = 0;
+    size_t size = 0;
+    bool exhausted = false;
+
+    explicit NumberReader(istream& in)
+        : input(in), buffer(1 << 16) {}
+
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    // Read the next number, returning false at the end of the input
+    bool next(double& value) {
+        for (;;) {
+            while (position < size && isSpace(buffer[position])) {
+                position++;
+            }
+
+            size_t end = position;
+            while (end < size && !isSpace(buffer[end])) {
+                end++;
+            }
+
+            // A token is complete once whitespace or the end of the input follows it
+            if (end < size || (exhausted && end > position)) {
+                from_chars_result result = from_chars(buffer.data() + position, buffer.data() + end, value);
+
+                if (result.ec != errc() || result.ptr != buffer.data() + end) {
+                    cerr << "Error: Invalid number in the input stream." << endl;
+                    exit(1);
+                }
+
+                position = end;
+                return true;
+            }
+
+            if (exhausted) {
+                return false;
+            }
+
+            // A token filling the whole buffer can never be completed, and no number is that long
+            if (position == 0 && size == buffer.size()) {
+                cerr << "Error: The input stream contains a token longer than " << buffer.size() << " characters." << endl;
+                exit(1);
+            }
+
+            // Move the partial token to the front and fill the rest of the buffer
+            copy(buffer.begin() + position, buffer.begin() + size, buffer.begin());
+            size -= position;
+            position = 0;
+
+            input.read(buffer.data() + size, buffer.size() - size);
+            size += static_cast<size_t>(input.gcount());
+            exhausted = size < buffer.size();
+        }
+    }
+};
+
+// Function to integrate a stream of gyro samples. Each step holds one "wx wy wz dt" sample per sensor, in
+// sensor order; the orientations are written every outputInterval steps (0 for only at the end).
+// Memory use is fixed by the number of sensors, whatever the length of the stream.
+// complete is false when the stream ends in the middle of a step; the finished steps are still written.
+size_t runImuStream(istream& input, ostream& output, size_t sensors, size_t outputInterval, OrientationIntegrator& integrator,
+    bool& complete) {
+    NumberReader reader(input);
+    QuaternionWriter writer(output);
+    double sample[4];
+
+    for (;;) {
+        for (size_t sensor = 0; sensor < sensors; sensor++) {
+            for (int c = 0; c < 4; c++) {
+                if (!reader.next(sample[c])) {
+                    complete = sensor == 0 && c == 0;
+                    if (!complete) {
+                        cerr << "Error: The input stream ends in the middle of a step." << endl;
+                    }
+
+                    if (outputInterval == 0 || integrator.steps % outputInterval != 0) {
+                        for (size_t n = 0; n < sensors; n++) {
+                            writer.write(integrator.orientations.get(n));
+                        }
+                    }
+
+                    return integrator.steps;
+                }
+            }
+
+            integrator.setSample(sensor, sample[0], sample[1], sample[2], sample[3]);
+        }
+
+        integrator.step();
+
+        if (outputInterval != 0 && integrator.steps % outputInterval == 0) {
+            for (size_t n = 0; n < sensors; n++) {
+                writer.write(integrator.orientations.get(n));
+            }
+        }
+    }
+}
+
+// Function to parse a whole command-line argument as a non-negative integer, returning false if it is not one
+bool parseCountArgument(const char* text, size_t& value) {
+    const char* end = text + strlen(text);
+    unsigned long long parsed = 0;
+    from_chars_result result = from_chars(text, end, parsed);
+
+    if (result.ec != errc() || result.ptr != end || parsed > numeric_limits<size_t>::max()) {
+        return false;
+    }
+
+    value = static_cast<size_t>(parsed);
+    return true;
+}
+
+// Function to parse a whole command-line argument as a finite number, returning false if it is not one
+bool parseNumberArgument(const char* text, double& value) {
+    const char* end = text + strlen(text);
+    double parsed = 0;
+    from_chars_result result = from_chars(text, end, parsed);
+
+    if (result.ec != errc() || result.ptr != end || !isfinite(parsed)) {
+        return false;
+    }
+
+    value = parsed;
+    return true;
+}
+
+// Function to run the IMU mode: QuaCal --imu <sensors> <input|-> [output|-] [tolerance] [outputInterval]
+int runImuMode(int argc, char* argv[]) {
+    if (argc < 4) {
+        cerr << "Usage: QuaCal --imu <sensors> <input|-> [output|-] [tolerance] [outputInterval]" << endl;
+        return 1;
+    }
+
+    ios::sync_with_stdio(false);
+
+    size_t sensors = 0;
+    string inputName = argv[3];
+    string outputName = argc > 4 ? argv[4] : "-";
+    double tolerance = 1e-12;
+    size_t outputInterval = 0;
+
+    if (!parseCountArgument(argv[2], sensors) || sensors == 0) {
+        cerr << "Error: The number of sensors must be a positive integer." << endl;
+        return 1;
+    }
+
+    if (argc > 5 && (!parseNumberArgument(argv[5], tolerance) || !(tolerance > 0))) {
+        cerr << "Error: The drift tolerance must be a positive number." << endl;
+        return 1;
+    }
+
+    if (argc > 6 && !parseCountArgument(argv[6], outputInterval)) {
+        cerr << "Error: The output interval must be a non-negative integer." << endl;
+        return 1;
+    }
+
+    ifstream inputFile;
+    ofstream outputFile;
+
+    if (inputName != "-") {
+        inputFile.open(inputName, ios::binary);
+        if (!inputFile) {
+            cerr << "Error: Failed to open the input file." << endl;
+            return 1;
+        }
+    }
+
+    if (outputName != "-") {
+        outputFile.open(outputName, ios::binary);
+        if (!outputFile) {
+            cerr << "Error: Failed to open the output file." << endl;
+            return 1;
+        }
+    }
+
+    istream& input = inputName != "-" ? static_cast<istream&>(inputFile) : cin;
+    ostream& output = outputName != "-" ? static_cast<ostream&>(outputFile) : cout;
+
+    OrientationIntegrator integrator(sensors, tolerance);
+
+    auto start = chrono::steady_clock::now();
+    bool complete = true;
+    size_t steps = runImuStream(input, output, sensors, outputInterval, integrator, complete);
+    output.flush();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cerr << "Integrated " << steps << " steps of " << sensors << " sensors in " << seconds << " s ("
+        << (seconds > 0 ? steps * sensors / seconds : 0.0) << " samples/sec), " << integrator.checks << " drift checks, "
+        << integrator.renormalized << " renormalizations" << endl;
+
+    return complete ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--imu") {
+        return runImuMode(argc, argv);
+    }
+
+    if (argc > 1 && string(argv[1]) == "--benchmark") {
+        size_t count = 10000000;
+
+        if (argc > 2 && (!parseCountArgument(argv[2], count) || count == 0)) {
+            cerr << "Error: The benchmark count must be a positive integer." << endl;
+            return 1;
+        }
+
+        runQuaternionBenchmark(count);
+        runLatencyBenchmark(count);
+        runDualQuaternionBenchmark(count);
+        return 0;
+    }
+
     ifstream inputFile("Quaternion.txt");
 
     if (!inputFile) {
@@ -102,11 +2311,11 @@ int main() {
     string quaternionStrA, quaternionStrB;
     double scalar;
 
-    // Read quaternion A
-    getline(inputFile, quaternionStrA);
+    // Read quaternion A, skipping blank lines
+    while (getline(inputFile, quaternionStrA) && quaternionStrA.find_first_not_of(" \t\r") == string::npos) {}
 
-    // Read quaternion B
-    getline(inputFile, quaternionStrB);
+    // Read quaternion B, skipping blank lines
+    while (getline(inputFile, quaternionStrB) && quaternionStrB.find_first_not_of(" \t\r") == string::npos) {}
 
     // Read scalar value
     inputFile >> scalar;
@@ -3,36 +3,49 @@
 #include <sstream>
 #include <cmath>
 #include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <cerrno>
+#include <cstdlib>
+
+#include "../../Common/MatrixCore.h"
+#include "../../Common/QuaternionCore.h"
 
 using namespace std;
 
-// Quaternion structure
-struct Quaternion {
-    double w, x, y, z;
-};
+// Precision of the quaternions; build with SLERPCAL_REAL=float or long double to change it
+#ifndef SLERPCAL_REAL
+#define SLERPCAL_REAL double
+#endif
+
+typedef QuaternionCore::Quaternion<SLERPCAL_REAL> Quaternion;
+typedef Quaternion::value_type Real;
 
 // Function to parse a quaternion from a string
 Quaternion parseQuaternion(const string& str) {
     Quaternion quaternion;
     stringstream ss(str);
     char dummy;
-    ss >> dummy >> quaternion.w >> dummy >> quaternion.x >> dummy >> quaternion.y >> dummy >> quaternion.z >> dummy;
+    ss >> dummy >> quaternion.scalar >> dummy >> quaternion.i >> dummy >> quaternion.j >> dummy >> quaternion.k >> dummy;
     return quaternion;
 }
 
 // Function to display a quaternion
 void displayQuaternion(const Quaternion& quaternion) {
-    cout << quaternion.w << " + " << quaternion.x << "i + " << quaternion.y << "j + " << quaternion.z << "k" << endl;
+    cout << quaternion.scalar << " + " << quaternion.i << "i + " << quaternion.j << "j + " << quaternion.k << "k" << endl;
 }
 
 // Function to convert a quaternion to its induced matrix
 vector<vector<double>> quaternionToMatrix(const Quaternion& quaternion) {
     vector<vector<double>> matrix(3, vector<double>(3));
 
-    double w = quaternion.w;
-    double x = quaternion.x;
-    double y = quaternion.y;
-    double z = quaternion.z;
+    double w = quaternion.scalar;
+    double x = quaternion.i;
+    double y = quaternion.j;
+    double z = quaternion.k;
 
     matrix[0][0] = 1 - 2 * y * y - 2 * z * z;
     matrix[0][1] = 2 * x * y - 2 * w * z;
@@ -49,71 +62,896 @@ vector<vector<double>> quaternionToMatrix(const Quaternion& quaternion) {
 
 // Function to multiply two matrices
 vector<vector<double>> multiplyMatrices(const vector<vector<double>>& matrix1, const vector<vector<double>>& matrix2) {
-    size_t m1 = matrix1.size();
     size_t n1 = matrix1[0].size();
     size_t m2 = matrix2.size();
-    size_t n2 = matrix2[0].size();
 
     if (n1 != m2) {
         cerr << "Error: Incompatible matrix dimensions for multiplication." << endl;
         exit(1);
     }
 
-    vector<vector<double>> result(m1, vector<double>(n2));
+    return MatrixCore::multiply(matrix1, matrix2);
+}
 
-    for (size_t i = 0; i < m1; i++) {
-        for (size_t j = 0; j < n2; j++) {
-            double sum = 0.0;
+// Function to approximate sin(x) for x in [0, pi / 2] without calling libm, so loops over it vectorize.
+// Above pi / 4 it uses sin(x) = cos(pi / 2 - x); both are the fdlibm minimax polynomials on [-pi / 4, pi / 4].
+// Max absolute error 2.3e-16 in double; long double gets the same accuracy as double.
+inline Real approximateSin(Real x) {
+    const Real quarterPi = Real(7.85398163397448278999e-01);
+    const Real halfPi = Real(1.57079632679489661923e+00);
+
+    // The selections below are arithmetic rather than branches, so loops calling this vectorize
+    Real complement = halfPi - x;
+    Real reflected = Real(x > quarterPi);
+    Real r = complement < x ? complement : x;
+    Real r2 = r * r;
+
+    Real sine = r + r * r2 * (Real(-1.66666666666666324348e-01) + r2 * (Real(8.33333333332248946124e-03) +
+        r2 * (Real(-1.98412698298579493134e-04) + r2 * (Real(2.75573137070700676789e-06) +
+        r2 * (Real(-2.50507602534068634195e-08) + r2 * Real(1.58969099521155010221e-10))))));
+    Real cosine = Real(1) - Real(0.5) * r2 + r2 * r2 * (Real(4.16666666666666019037e-02) + r2 * (Real(-1.38888888888741095749e-03) +
+        r2 * (Real(2.48015872894767294178e-05) + r2 * (Real(-2.75573143513906633035e-07) +
+        r2 * (Real(2.08757232129817482790e-09) + r2 * Real(-1.13596475577881948265e-11))))));
+
+    return reflected * cosine + (Real(1) - reflected) * sine;
+}
 
-            for (size_t k = 0; k < n1; k++) {
-                sum += matrix1[i][k] * matrix2[k][j];
-            }
+// Structure to hold many quaternions as four separate component arrays (structure of arrays)
+struct QuaternionArray {
+    size_t count = 0;
+    vector<Real> scalar;
+    vector<Real> i;
+    vector<Real> j;
+    vector<Real> k;
+
+    explicit QuaternionArray(size_t n = 0)
+        : count(n), scalar(n), i(n), j(n), k(n) {}
 
-            result[i][j] = sum;
+    Quaternion get(size_t index) const {
+        return Quaternion(scalar[index], i[index], j[index], k[index]);
+    }
+
+    void set(size_t index, const Quaternion& quaternion) {
+        scalar[index] = quaternion.scalar;
+        i[index] = quaternion.i;
+        j[index] = quaternion.j;
+        k[index] = quaternion.k;
+    }
+};
+
+// Function to check that two quaternion arrays can be combined elementwise
+void checkQuaternionArraySizes(size_t a, size_t b) {
+    if (a != b) {
+        cerr << "Error: Quaternion arrays have different lengths." << endl;
+        exit(1);
+    }
+}
+
+// Structure to hold the per-pair work of slerp, done once and reused for every t: both quaternions at unit
+// length with b in a's hemisphere, the angle theta between them and 1 / sin(theta)
+struct SlerpPair {
+    Quaternion a;
+    Quaternion b;
+    Real theta;
+    Real inverseSinTheta;
+};
+
+// Function to prepare a pair of quaternions for slerpTimes. theta = 2 atan2(|a - b|, |a + b|) stays accurate
+// for nearly parallel pairs, where acos(a . b) does not, so no switch to linear interpolation is needed.
+SlerpPair prepareSlerp(const Quaternion& quaternionA, const Quaternion& quaternionB) {
+    SlerpPair pair;
+    pair.a = QuaternionCore::normalizeQuaternion(quaternionA);
+    pair.b = QuaternionCore::normalizeQuaternion(quaternionB);
+
+    if (calculateDotProduct(pair.a, pair.b) < 0) {
+        pair.b = -pair.b;
+    }
+
+    // |a - b| = 2 sin(theta / 2) and |a + b| = 2 cos(theta / 2), so their product is 2 sin(theta)
+    Quaternion difference = pair.a - pair.b;
+    Quaternion sum = pair.a + pair.b;
+    Real differenceNorm = sqrt(calculateDotProduct(difference, difference));
+    Real sumNorm = sqrt(calculateDotProduct(sum, sum));
+    pair.theta = 2 * atan2(differenceNorm, sumNorm);
+    pair.inverseSinTheta = 2 / (differenceNorm * sumNorm);
+
+    if (pair.theta == 0) {
+        // a = b: an angle of epsilon, where sin is linear, gives the weights 1 - t and t with no special case
+        pair.theta = numeric_limits<Real>::epsilon();
+        pair.inverseSinTheta = 1 / pair.theta;
+    }
+
+    return pair;
+}
+
+// Function to evaluate slerp of one prepared pair at many t in [0, 1], writing sample n to out[n]
+void slerpTimes(const SlerpPair& pair, const Real* times, QuaternionArray& out) {
+    // Local copies, so the compiler knows the stores to out cannot change them
+    const Quaternion a = pair.a;
+    const Quaternion b = pair.b;
+    const Real theta = pair.theta;
+    const Real inverseSinTheta = pair.inverseSinTheta;
+    Real* scalar = out.scalar.data();
+    Real* i = out.i.data();
+    Real* j = out.j.data();
+    Real* k = out.k.data();
+
+    for (size_t n = 0; n < out.count; n++) {
+        Real t = times[n];
+        Real weightA = approximateSin((1 - t) * theta) * inverseSinTheta;
+        Real weightB = approximateSin(t * theta) * inverseSinTheta;
+
+        scalar[n] = weightA * a.scalar + weightB * b.scalar;
+        i[n] = weightA * a.i + weightB * b.i;
+        j[n] = weightA * a.j + weightB * b.j;
+        k[n] = weightA * a.k + weightB * b.k;
+    }
+}
+
+// Structure to hold many prepared pairs as arrays, for interpolating many pairs at once
+struct SlerpPairArray {
+    size_t count = 0;
+    QuaternionArray a;
+    QuaternionArray b;
+    vector<Real> theta;
+    vector<Real> inverseSinTheta;
+
+    explicit SlerpPairArray(size_t n = 0)
+        : count(n), a(n), b(n), theta(n), inverseSinTheta(n) {}
+};
+
+// Function to prepare every pair (a[n], b[n]) as prepareSlerp does
+void prepareSlerpPairs(const QuaternionArray& a, const QuaternionArray& b, SlerpPairArray& pairs) {
+    checkQuaternionArraySizes(a.count, b.count);
+    checkQuaternionArraySizes(a.count, pairs.count);
+
+    for (size_t n = 0; n < a.count; n++) {
+        SlerpPair pair = prepareSlerp(a.get(n), b.get(n));
+        pairs.a.set(n, pair.a);
+        pairs.b.set(n, pair.b);
+        pairs.theta[n] = pair.theta;
+        pairs.inverseSinTheta[n] = pair.inverseSinTheta;
+    }
+}
+
+// Function to evaluate slerp of every prepared pair at its own t in [0, 1], writing pair n's sample to out[n]
+void slerpPairs(const SlerpPairArray& pairs, const Real* times, QuaternionArray& out) {
+    checkQuaternionArraySizes(pairs.count, out.count);
+
+    const Real* aScalar = pairs.a.scalar.data();
+    const Real* aI = pairs.a.i.data();
+    const Real* aJ = pairs.a.j.data();
+    const Real* aK = pairs.a.k.data();
+    const Real* bScalar = pairs.b.scalar.data();
+    const Real* bI = pairs.b.i.data();
+    const Real* bJ = pairs.b.j.data();
+    const Real* bK = pairs.b.k.data();
+    const Real* thetas = pairs.theta.data();
+    const Real* inverseSinThetas = pairs.inverseSinTheta.data();
+    Real* scalar = out.scalar.data();
+    Real* i = out.i.data();
+    Real* j = out.j.data();
+    Real* k = out.k.data();
+
+    // Weights go to a small local block and the components are combined one at a time, so every loop
+    // touches few enough arrays for the compiler's aliasing checks and vectorizes
+    const size_t blockSize = 256;
+    Real weightA[blockSize];
+    Real weightB[blockSize];
+
+    for (size_t start = 0; start < pairs.count; start += blockSize) {
+        size_t length = min(blockSize, pairs.count - start);
+
+        for (size_t m = 0; m < length; m++) {
+            Real t = times[start + m];
+            Real theta = thetas[start + m];
+            weightA[m] = approximateSin((1 - t) * theta) * inverseSinThetas[start + m];
+            weightB[m] = approximateSin(t * theta) * inverseSinThetas[start + m];
+        }
+
+        for (size_t m = 0; m < length; m++) {
+            scalar[start + m] = weightA[m] * aScalar[start + m] + weightB[m] * bScalar[start + m];
+        }
+        for (size_t m = 0; m < length; m++) {
+            i[start + m] = weightA[m] * aI[start + m] + weightB[m] * bI[start + m];
+        }
+        for (size_t m = 0; m < length; m++) {
+            j[start + m] = weightA[m] * aJ[start + m] + weightB[m] * bJ[start + m];
+        }
+        for (size_t m = 0; m < length; m++) {
+            k[start + m] = weightA[m] * aK[start + m] + weightB[m] * bK[start + m];
         }
     }
+}
 
-    return result;
+// Function to approximate sin(t theta) / sin(theta) without trigonometric functions, for theta in [0, pi/2],
+// given cosThetaMinusOne = cos(theta) - 1 (D. Eberly, "A Fast and Accurate Algorithm for Computing SLERP").
+// The series in cos(theta) - 1 is cut after 8 terms, and the last term is scaled by 1 + mu to balance the
+// truncation error over t in [0, 1]. The weight is then within 1.9e-5 of the exact one.
+inline Real approximateSlerpWeight(Real t, Real cosThetaMinusOne) {
+    const Real onePlusMu = Real(1.85298109240830);
+    Real t2 = t * t;
+
+    // Term n is (t^2 - n^2) / (n (2n + 1)) (cos(theta) - 1), nested as 1 + term1 (1 + term2 (1 + ...))
+    Real weight = 1 + onePlusMu * (t2 - 64) * (Real(1) / (8 * 17)) * cosThetaMinusOne;
+    weight = 1 + (t2 - 49) * (Real(1) / (7 * 15)) * cosThetaMinusOne * weight;
+    weight = 1 + (t2 - 36) * (Real(1) / (6 * 13)) * cosThetaMinusOne * weight;
+    weight = 1 + (t2 - 25) * (Real(1) / (5 * 11)) * cosThetaMinusOne * weight;
+    weight = 1 + (t2 - 16) * (Real(1) / (4 * 9)) * cosThetaMinusOne * weight;
+    weight = 1 + (t2 - 9) * (Real(1) / (3 * 7)) * cosThetaMinusOne * weight;
+    weight = 1 + (t2 - 4) * (Real(1) / (2 * 5)) * cosThetaMinusOne * weight;
+    weight = 1 + (t2 - 1) * (Real(1) / (1 * 3)) * cosThetaMinusOne * weight;
+
+    return t * weight;
 }
 
-// Function to perform quaternion Slerp interpolation
-Quaternion slerp(const Quaternion& quaternionA, const Quaternion& quaternionB, double t) {
-    double cosTheta = quaternionA.w * quaternionB.w + quaternionA.x * quaternionB.x + quaternionA.y * quaternionB.y + quaternionA.z * quaternionB.z;
+// Function to approximate slerp of two unit quaternions with only multiplications and additions.
+// The hemisphere flip is a sign on b's weight, and rounding that puts |a . b| just above 1 is harmless
+// because the weights are polynomials. Over all t in [0, 1] and all pairs the result is at most
+// 1.7e-5 radians (0.001 degrees) of rotation away from slerp, and its length is within 2.9e-5 of 1.
+Quaternion approximateSlerp(const Quaternion& a, const Quaternion& b, Real t) {
+    Real cosTheta = calculateDotProduct(a, b);
+    Real sign = copysign(Real(1), cosTheta);
+    Real cosThetaMinusOne = fabs(cosTheta) - 1;
+
+    return multiplyByScalar(a, approximateSlerpWeight(1 - t, cosThetaMinusOne)) +
+        multiplyByScalar(b, sign * approximateSlerpWeight(t, cosThetaMinusOne));
+}
 
-    if (cosTheta < 0) {
-        // Invert one of the quaternions to take the shortest path
-        cosTheta = -cosTheta;
-        Quaternion invertedQuaternionB = { -quaternionB.w, -quaternionB.x, -quaternionB.y, -quaternionB.z };
-        return slerp(quaternionA, invertedQuaternionB, t);
+// Function to evaluate approximateSlerp of one pair of unit quaternions at many t, writing sample n to out[n]
+void approximateSlerpTimes(const Quaternion& quaternionA, const Quaternion& quaternionB, const Real* times, QuaternionArray& out) {
+    const Quaternion a = quaternionA;
+    const Real cosTheta = calculateDotProduct(quaternionA, quaternionB);
+    const Quaternion b = multiplyByScalar(quaternionB, copysign(Real(1), cosTheta));
+    const Real cosThetaMinusOne = fabs(cosTheta) - 1;
+    Real* scalar = out.scalar.data();
+    Real* i = out.i.data();
+    Real* j = out.j.data();
+    Real* k = out.k.data();
+
+    for (size_t n = 0; n < out.count; n++) {
+        Real t = times[n];
+        Real weightA = approximateSlerpWeight(1 - t, cosThetaMinusOne);
+        Real weightB = approximateSlerpWeight(t, cosThetaMinusOne);
+
+        scalar[n] = weightA * a.scalar + weightB * b.scalar;
+        i[n] = weightA * a.i + weightB * b.i;
+        j[n] = weightA * a.j + weightB * b.j;
+        k[n] = weightA * a.k + weightB * b.k;
     }
+}
 
-    double theta = acos(cosTheta);
-    double sinTheta = sqrt(1 - cosTheta * cosTheta);
+// Function to evaluate approximateSlerp of every pair of unit quaternions (a[n], b[n]) at its own t,
+// writing pair n's sample to out[n]; no preparation is needed
+void approximateSlerpPairs(const QuaternionArray& a, const QuaternionArray& b, const Real* times, QuaternionArray& out) {
+    checkQuaternionArraySizes(a.count, b.count);
+    checkQuaternionArraySizes(a.count, out.count);
+
+    const Real* aScalar = a.scalar.data();
+    const Real* aI = a.i.data();
+    const Real* aJ = a.j.data();
+    const Real* aK = a.k.data();
+    const Real* bScalar = b.scalar.data();
+    const Real* bI = b.i.data();
+    const Real* bJ = b.j.data();
+    const Real* bK = b.k.data();
+    Real* scalar = out.scalar.data();
+    Real* i = out.i.data();
+    Real* j = out.j.data();
+    Real* k = out.k.data();
+
+    // Blocked as in slerpPairs, so that every loop vectorizes
+    const size_t blockSize = 256;
+    Real weightA[blockSize];
+    Real weightB[blockSize];
+
+    for (size_t start = 0; start < a.count; start += blockSize) {
+        size_t length = min(blockSize, a.count - start);
+
+        for (size_t m = 0; m < length; m++) {
+            size_t n = start + m;
+            Real t = times[n];
+            Real cosTheta = aScalar[n] * bScalar[n] + aI[n] * bI[n] + aJ[n] * bJ[n] + aK[n] * bK[n];
+            Real cosThetaMinusOne = fabs(cosTheta) - 1;
+            weightA[m] = approximateSlerpWeight(1 - t, cosThetaMinusOne);
+            weightB[m] = copysign(Real(1), cosTheta) * approximateSlerpWeight(t, cosThetaMinusOne);
+        }
 
-    if (fabs(sinTheta) < 0.001) {
-        // Quaternions are very close, use linear interpolation
-        double s = 1 - t;
-        double w = s * quaternionA.w + t * quaternionB.w;
-        double x = s * quaternionA.x + t * quaternionB.x;
-        double y = s * quaternionA.y + t * quaternionB.y;
-        double z = s * quaternionA.z + t * quaternionB.z;
-        double norm = sqrt(w * w + x * x + y * y + z * z);
-        return { w / norm, x / norm, y / norm, z / norm };
+        for (size_t m = 0; m < length; m++) {
+            scalar[start + m] = weightA[m] * aScalar[start + m] + weightB[m] * bScalar[start + m];
+        }
+        for (size_t m = 0; m < length; m++) {
+            i[start + m] = weightA[m] * aI[start + m] + weightB[m] * bI[start + m];
+        }
+        for (size_t m = 0; m < length; m++) {
+            j[start + m] = weightA[m] * aJ[start + m] + weightB[m] * bJ[start + m];
+        }
+        for (size_t m = 0; m < length; m++) {
+            k[start + m] = weightA[m] * aK[start + m] + weightB[m] * bK[start + m];
+        }
     }
+}
+
+// Function to evaluate slerp of a prepared pair at one t with the exact sine
+Quaternion evaluateSlerp(const SlerpPair& pair, Real t) {
+    return multiplyByScalar(pair.a, sin((1 - t) * pair.theta) * pair.inverseSinTheta) +
+        multiplyByScalar(pair.b, sin(t * pair.theta) * pair.inverseSinTheta);
+}
 
-    double s1 = sin((1 - t) * theta);
-    double s2 = sin(t * theta);
+// Structure to generate slerp(a, b, t) at count evenly spaced t from 0 to 1, one sample per next().
+// slerp(a, b, t) = a (conj(a) b)^t, so each sample is the previous one times the fixed step (conj(a) b)^(1 / (count - 1)).
+// Every anchorInterval samples, and at the last one, the sample is evaluated exactly instead, which bounds the drift.
+struct SlerpStepper {
+    SlerpPair pair;
+    Quaternion step;
+    Quaternion current;
+    Real stepSize;
+    size_t count;
+    size_t anchorInterval;
+    size_t samplesUntilAnchor;
+    size_t index = 0;
+
+    SlerpStepper(const Quaternion& a, const Quaternion& b, size_t sampleCount, size_t interval = 64)
+        : pair(prepareSlerp(a, b)), stepSize(Real(1) / Real(max<size_t>(sampleCount, 2) - 1)), count(sampleCount),
+        anchorInterval(max<size_t>(interval, 1)), samplesUntilAnchor(anchorInterval) {
+        // conj(a) b = (cos(theta), sin(theta) axis), so its power is (cos(h theta), sin(h theta) axis)
+        Quaternion relative = calculateConjugate(pair.a) * pair.b;
+        Real axisScale = sin(stepSize * pair.theta) * pair.inverseSinTheta;
+        step = Quaternion(cos(stepSize * pair.theta), relative.i * axisScale, relative.j * axisScale, relative.k * axisScale);
+        current = pair.a;
+    }
+
+    Quaternion next() {
+        Quaternion sample = current;
+        index++;
 
-    double w = (s1 * quaternionA.w + s2 * quaternionB.w) / sinTheta;
-    double x = (s1 * quaternionA.x + s2 * quaternionB.x) / sinTheta;
-    double y = (s1 * quaternionA.y + s2 * quaternionB.y) / sinTheta;
-    double z = (s1 * quaternionA.z + s2 * quaternionB.z) / sinTheta;
-    double norm = sqrt(w * w + x * x + y * y + z * z);
+        if (--samplesUntilAnchor == 0 || index + 1 == count) {
+            samplesUntilAnchor = anchorInterval;
+            current = evaluateSlerp(pair, index + 1 == count ? Real(1) : Real(index) * stepSize);
+        } else {
+            current = current * step;
+        }
 
-    return { w / norm, x / norm, y / norm, z / norm };
+        return sample;
+    }
+};
+
+// Structure to generate the same samples as SlerpStepper with the recurrence q(n + 1) = 2 cos(h theta) q(n) - q(n - 1).
+// Every component of slerp at t = n h is a combination of sin(n h theta) and cos(n h theta), and those follow the
+// Chebyshev recurrence, so each sample costs four multiply-adds. The recurrence amplifies rounding more than the
+// quaternion product does, so it is re-anchored more often.
+struct SlerpRecurrence {
+    SlerpPair pair;
+    Quaternion previous;
+    Quaternion current;
+    Real twoCosStep;
+    Real stepSize;
+    size_t count;
+    size_t anchorInterval;
+    size_t samplesUntilAnchor;
+    size_t index = 0;
+
+    SlerpRecurrence(const Quaternion& a, const Quaternion& b, size_t sampleCount, size_t interval = 16)
+        : pair(prepareSlerp(a, b)), stepSize(Real(1) / Real(max<size_t>(sampleCount, 2) - 1)), count(sampleCount),
+        anchorInterval(max<size_t>(interval, 1)), samplesUntilAnchor(anchorInterval) {
+        twoCosStep = 2 * cos(stepSize * pair.theta);
+        // The sample before the first one, at t = -h
+        previous = evaluateSlerp(pair, -stepSize);
+        current = pair.a;
+    }
+
+    Quaternion next() {
+        Quaternion sample = current;
+        index++;
+
+        if (--samplesUntilAnchor == 0 || index + 1 == count) {
+            samplesUntilAnchor = anchorInterval;
+            // Both samples the recurrence reads are replaced by exact ones
+            previous = evaluateSlerp(pair, Real(index - 1) * stepSize);
+            current = evaluateSlerp(pair, index + 1 == count ? Real(1) : Real(index) * stepSize);
+        } else {
+            Quaternion following = current * twoCosStep - previous;
+            previous = current;
+            current = following;
+        }
+
+        return sample;
+    }
+};
+
+// Function to take the logarithm of a unit quaternion (cos(theta), sin(theta) axis), which is (0, theta axis)
+Quaternion logarithmUnitQuaternion(const Quaternion& quaternion) {
+    Real vectorNorm = sqrt(quaternion.i * quaternion.i + quaternion.j * quaternion.j + quaternion.k * quaternion.k);
+    Real theta = atan2(vectorNorm, quaternion.scalar);
+    // theta / sin(theta) tends to 1
+    Real scale = vectorNorm > 0 ? theta / vectorNorm : 1;
+    return Quaternion(0, quaternion.i * scale, quaternion.j * scale, quaternion.k * scale);
+}
+
+// Function to take the exponential of a pure quaternion (0, theta axis), which is (cos(theta), sin(theta) axis)
+Quaternion exponentialPureQuaternion(const Quaternion& quaternion) {
+    Real theta = sqrt(quaternion.i * quaternion.i + quaternion.j * quaternion.j + quaternion.k * quaternion.k);
+    // sin(theta) / theta tends to 1
+    Real scale = theta > 0 ? sin(theta) / theta : 1;
+    return Quaternion(cos(theta), quaternion.i * scale, quaternion.j * scale, quaternion.k * scale);
+}
+
+// Kinds of quaternion spline through a sequence of keys
+enum SplineKind {
+    // Shoemake's spherical quadrangle interpolation, one inner control quaternion per key
+    SPLINE_SQUAD,
+    // Catmull-Rom tangents turned into spherical Bezier segments, an incoming and an outgoing control per key
+    SPLINE_CATMULL_ROM
+};
+
+// Structure to hold a quaternion spline: key times in increasing order, unit keys in one hemisphere chain
+// and the inner control quaternions, which prepareSpline computes once so that evaluation is only slerps
+struct QuaternionSpline {
+    SplineKind kind = SPLINE_SQUAD;
+    vector<Real> times;
+    QuaternionArray keys;
+    // SQUAD: the inner quaternion of each key; Catmull-Rom: the control before each key
+    QuaternionArray incoming;
+    // Catmull-Rom: the control after each key; unused for SQUAD
+    QuaternionArray outgoing;
+};
+
+// Function to prepare a spline through the keys at the given times, which must increase.
+// Each key is flipped into its predecessor's hemisphere, so every segment follows the shorter arc.
+// The key before the first and after the last are taken to repeat the end keys.
+QuaternionSpline prepareSpline(SplineKind kind, const vector<Real>& times, const QuaternionArray& keys) {
+    checkQuaternionArraySizes(times.size(), keys.count);
+
+    if (keys.count < 2) {
+        cerr << "Error: A spline needs at least two keys." << endl;
+        exit(1);
+    }
+
+    for (size_t n = 1; n < times.size(); n++) {
+        if (!(times[n] > times[n - 1])) {
+            cerr << "Error: Spline key times must increase." << endl;
+            exit(1);
+        }
+    }
+
+    size_t count = keys.count;
+    QuaternionSpline spline;
+    spline.kind = kind;
+    spline.times = times;
+    spline.keys = QuaternionArray(count);
+    spline.incoming = QuaternionArray(count);
+    spline.outgoing = QuaternionArray(kind == SPLINE_CATMULL_ROM ? count : 0);
+
+    for (size_t n = 0; n < count; n++) {
+        Quaternion key = QuaternionCore::normalizeQuaternion(keys.get(n));
+
+        if (n > 0 && calculateDotProduct(spline.keys.get(n - 1), key) < 0) {
+            key = -key;
+        }
+
+        spline.keys.set(n, key);
+    }
+
+    for (size_t n = 0; n < count; n++) {
+        Quaternion key = spline.keys.get(n);
+        Quaternion inverse = calculateConjugate(key);
+        // Logarithms of the steps to the neighbours, in the key's own frame
+        Quaternion toNext = logarithmUnitQuaternion(inverse * spline.keys.get(min(n + 1, count - 1)));
+        Quaternion toPrevious = logarithmUnitQuaternion(inverse * spline.keys.get(n > 0 ? n - 1 : 0));
+        // Durations of the segments either side of the key; a repeated end key is one segment away
+        Real before = n > 0 ? times[n] - times[n - 1] : times[1] - times[0];
+        Real after = n + 1 < count ? times[n + 1] - times[n] : before;
+
+        // Both kinds share the angular velocity (toNext - toPrevious) / (before + after) at the key, and each
+        // segment scales it by its own duration, so the velocity matches across keys at uneven times
+        if (kind == SPLINE_SQUAD) {
+            // With equal durations this is Shoemake's -(toNext + toPrevious) / 4
+            Quaternion toInner = (toNext * before + toPrevious * after) * (Real(-0.5) / (before + after));
+            spline.incoming.set(n, key * exponentialPureQuaternion(toInner));
+        } else {
+            // The Bezier controls sit a third of each segment's share of the velocity on either side of the key
+            Quaternion velocity = (toNext - toPrevious) * (1 / (before + after));
+            spline.incoming.set(n, key * exponentialPureQuaternion(velocity * (-before / 3)));
+            spline.outgoing.set(n, key * exponentialPureQuaternion(velocity * (after / 3)));
+        }
+    }
+
+    return spline;
+}
+
+// Function to find the segment whose keys surround time: the last key at or before it, clamped to the segments.
+// Binary search, O(log keys).
+size_t findSplineSegment(const QuaternionSpline& spline, Real time) {
+    size_t after = upper_bound(spline.times.begin(), spline.times.end(), time) - spline.times.begin();
+    return min(max<size_t>(after, 1), spline.times.size() - 1) - 1;
+}
+
+// Structure to remember the segment of the previous lookup. Samples in order mostly stay in the same segment
+// or move to the next one, so the lookup is O(1) amortized; any other jump falls back to the binary search.
+struct SplineCursor {
+    size_t segment = 0;
+
+    size_t find(const QuaternionSpline& spline, Real time) {
+        const vector<Real>& times = spline.times;
+        size_t last = times.size() - 2;
+
+        if (segment <= last && (time >= times[segment] || segment == 0) && (time < times[segment + 1] || segment == last)) {
+            return segment;
+        }
+
+        if (segment < last && time >= times[segment + 1] && (time < times[segment + 2] || segment + 1 == last)) {
+            return ++segment;
+        }
+
+        segment = findSplineSegment(spline, time);
+        return segment;
+    }
+};
+
+// Function to evaluate segment n of the spline at u in [0, 1].
+// Every slerp here runs without the hemisphere flip, as Shoemake's construction requires: prepareSpline already
+// chains the keys into one hemisphere, and the intermediate points of a segment with widely spaced keys can drift
+// more than 90 degrees apart, where a shorter-arc slerp would jump to the other side partway along the segment.
+Quaternion evaluateSplineSegment(const QuaternionSpline& spline, size_t n, Real u) {
+    using QuaternionCore::slerpWithoutFlip;
+
+    Quaternion start = spline.keys.get(n);
+    Quaternion end = spline.keys.get(n + 1);
+
+    if (spline.kind == SPLINE_SQUAD) {
+        // squad = slerp(slerp(q0, q1, u), slerp(s0, s1, u), 2u(1 - u))
+        return slerpWithoutFlip(slerpWithoutFlip(start, end, u),
+            slerpWithoutFlip(spline.incoming.get(n), spline.incoming.get(n + 1), u), 2 * u * (1 - u));
+    }
+
+    // De Casteljau's construction of the Bezier segment start, outgoing, incoming, end with slerp in place of lerp
+    Quaternion controlA = spline.outgoing.get(n);
+    Quaternion controlB = spline.incoming.get(n + 1);
+    Quaternion first = slerpWithoutFlip(start, controlA, u);
+    Quaternion middle = slerpWithoutFlip(controlA, controlB, u);
+    Quaternion last = slerpWithoutFlip(controlB, end, u);
+    return slerpWithoutFlip(slerpWithoutFlip(first, middle, u), slerpWithoutFlip(middle, last, u), u);
 }
 
-int main() {
+// Function to evaluate the spline at one time, clamped to the key range, finding the segment with the cursor
+Quaternion evaluateSpline(const QuaternionSpline& spline, SplineCursor& cursor, Real time) {
+    size_t n = cursor.find(spline, time);
+    Real u = (time - spline.times[n]) / (spline.times[n + 1] - spline.times[n]);
+    return evaluateSplineSegment(spline, n, min(max(u, Real(0)), Real(1)));
+}
+
+// Function to evaluate the spline at many times, writing sample n to out[n]. Times in increasing order
+// make every segment lookup O(1); any order gives the same samples.
+void evaluateSplineTimes(const QuaternionSpline& spline, const Real* times, QuaternionArray& out) {
+    SplineCursor cursor;
+
+    for (size_t n = 0; n < out.count; n++) {
+        out.set(n, evaluateSpline(spline, cursor, times[n]));
+    }
+}
+
+// Function to find the angle of the rotation between the orientations of two quaternions, in radians
+Real rotationAngleBetween(const Quaternion& quaternionA, const Quaternion& quaternionB) {
+    Quaternion a = QuaternionCore::normalizeQuaternion(quaternionA);
+    Quaternion b = QuaternionCore::normalizeQuaternion(quaternionB);
+    Quaternion difference = a - b;
+    Quaternion sum = a + b;
+    Real angle = 4 * atan2(sqrt(calculateDotProduct(difference, difference)), sqrt(calculateDotProduct(sum, sum)));
+    return min(angle, 4 * atan2(sqrt(calculateDotProduct(sum, sum)), sqrt(calculateDotProduct(difference, difference))));
+}
+
+// Function to find the largest angle between the orientations of two quaternion arrays, in radians
+Real largestAngleDifference(const QuaternionArray& expected, const QuaternionArray& actual) {
+    Real largest = 0;
+
+    for (size_t n = 0; n < expected.count; n++) {
+        largest = max(largest, rotationAngleBetween(expected.get(n), actual.get(n)));
+    }
+
+    return largest;
+}
+
+// Function to time a batched operation against looping the scalar function over the same data
+// Small counts are repeated so that every measurement covers roughly the same amount of work.
+template <typename Scalar, typename Batched>
+void benchmarkOperation(const string& name, size_t count, Scalar scalarLoop, Batched batched) {
+    size_t repeats = max<size_t>(1, 20000000 / max<size_t>(count, 1));
+
+    auto start = chrono::steady_clock::now();
+    for (size_t r = 0; r < repeats; r++) {
+        scalarLoop();
+    }
+    double scalarSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count() / repeats;
+
+    start = chrono::steady_clock::now();
+    for (size_t r = 0; r < repeats; r++) {
+        batched();
+    }
+    double batchedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count() / repeats;
+
+    cout << name << ": scalar " << scalarSeconds * 1e9 / count << " ns, batched " << batchedSeconds * 1e9 / count
+        << " ns per sample (" << scalarSeconds / batchedSeconds << "x)\n";
+}
+
+// Function to benchmark the slerp variants against calling slerp once per sample
+void runSlerpBenchmark(size_t count) {
+    mt19937_64 generator(42);
+    uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+    auto randomQuaternion = [&] {
+        return QuaternionCore::normalizeQuaternion(Quaternion(Real(distribution(generator)), Real(distribution(generator)),
+            Real(distribution(generator)), Real(distribution(generator))));
+    };
+
+    QuaternionArray a(count), b(count), expected(count), out(count);
+    vector<Real> times(count), randomTimes(count);
+
+    for (size_t n = 0; n < count; n++) {
+        a.set(n, randomQuaternion());
+        b.set(n, randomQuaternion());
+        times[n] = Real(n) / Real(max<size_t>(count - 1, 1));
+        randomTimes[n] = Real(0.5 * (distribution(generator) + 1.0));
+    }
+
+    cout << "Slerp benchmark over " << count << " samples:\n";
+
+    // One pair sampled at many t
+    Quaternion pairA = a.get(0), pairB = b.get(0);
+
+    benchmarkOperation("one pair, many t (slerp vs slerpTimes)", count,
+        [&] { for (size_t n = 0; n < count; n++) expected.set(n, slerp(pairA, pairB, times[n])); },
+        [&] { slerpTimes(prepareSlerp(pairA, pairB), times.data(), out); });
+
+    Real timesError = largestAngleDifference(expected, out);
+
+    // Many pairs, each at its own t
+    SlerpPairArray pairs(count);
+
+    benchmarkOperation("many pairs (slerp vs prepare + slerpPairs)", count,
+        [&] { for (size_t n = 0; n < count; n++) expected.set(n, slerp(a.get(n), b.get(n), randomTimes[n])); },
+        [&] { prepareSlerpPairs(a, b, pairs); slerpPairs(pairs, randomTimes.data(), out); });
+
+    Real pairsError = largestAngleDifference(expected, out);
+
+    benchmarkOperation("many pairs, prepared once (slerp vs slerpPairs)", count,
+        [&] { for (size_t n = 0; n < count; n++) expected.set(n, slerp(a.get(n), b.get(n), randomTimes[n])); },
+        [&] { slerpPairs(pairs, randomTimes.data(), out); });
+
+    cout << "Largest angle from slerp (radians): slerpTimes " << timesError << ", slerpPairs " << pairsError << "\n";
+}
+
+// Function to report how far approximateSlerp lands from slerp over t in [0, 1] and every angle between the
+// two orientations, from 0 to 360 degrees so that pairs needing the hemisphere flip are covered too
+void reportApproximateSlerpAccuracy() {
+    const int bands = 8;
+    const int anglesPerBand = 200;
+    const int timeSteps = 100;
+    const Real pi = Real(3.14159265358979323846);
+    const Quaternion start = QuaternionCore::normalizeQuaternion(Quaternion(1, 2, 3, 4));
+    const Quaternion axis = QuaternionCore::normalizeQuaternion(Quaternion(0, -2, 1, 3));
+
+    cout << "approximateSlerp against slerp (largest rotation error in radians, largest length error):\n";
+
+    Real overallAngle = 0, overallLength = 0;
+
+    for (int band = 0; band < bands; band++) {
+        Real bandAngle = 0, bandLength = 0;
+
+        for (int step = 0; step <= anglesPerBand; step++) {
+            Real rotation = 2 * pi * (band + Real(step) / anglesPerBand) / bands;
+            Quaternion end = start * (Quaternion(cos(rotation / 2)) + axis * sin(rotation / 2));
+
+            for (int sample = 0; sample <= timeSteps; sample++) {
+                Real t = Real(sample) / timeSteps;
+                Quaternion approximate = approximateSlerp(start, end, t);
+                bandAngle = max(bandAngle, rotationAngleBetween(slerp(start, end, t), approximate));
+                bandLength = max(bandLength, fabs(sqrt(calculateDotProduct(approximate, approximate)) - 1));
+            }
+        }
+
+        cout << "  " << 360 * band / bands << " to " << 360 * (band + 1) / bands << " degrees: "
+            << bandAngle << ", " << bandLength << "\n";
+        overallAngle = max(overallAngle, bandAngle);
+        overallLength = max(overallLength, bandLength);
+    }
+
+    cout << "  all angles: " << overallAngle << " radians (" << overallAngle * 180 / pi << " degrees), "
+        << overallLength << "\n";
+}
+
+// Function to benchmark approximateSlerp's batched forms against calling slerp once per sample
+void runApproximateSlerpBenchmark(size_t count) {
+    mt19937_64 generator(7);
+    uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+    auto randomQuaternion = [&] {
+        return QuaternionCore::normalizeQuaternion(Quaternion(Real(distribution(generator)), Real(distribution(generator)),
+            Real(distribution(generator)), Real(distribution(generator))));
+    };
+
+    QuaternionArray a(count), b(count), expected(count), out(count);
+    vector<Real> times(count), randomTimes(count);
+
+    for (size_t n = 0; n < count; n++) {
+        a.set(n, randomQuaternion());
+        b.set(n, randomQuaternion());
+        times[n] = Real(n) / Real(max<size_t>(count - 1, 1));
+        randomTimes[n] = Real(0.5 * (distribution(generator) + 1.0));
+    }
+
+    cout << "Approximate slerp benchmark over " << count << " samples:\n";
+
+    Quaternion pairA = a.get(0), pairB = b.get(0);
+
+    benchmarkOperation("one pair, many t (slerp vs approximateSlerpTimes)", count,
+        [&] { for (size_t n = 0; n < count; n++) expected.set(n, slerp(pairA, pairB, times[n])); },
+        [&] { approximateSlerpTimes(pairA, pairB, times.data(), out); });
+
+    Real timesError = largestAngleDifference(expected, out);
+
+    benchmarkOperation("many pairs (slerp vs approximateSlerpPairs)", count,
+        [&] { for (size_t n = 0; n < count; n++) expected.set(n, slerp(a.get(n), b.get(n), randomTimes[n])); },
+        [&] { approximateSlerpPairs(a, b, randomTimes.data(), out); });
+
+    Real pairsError = largestAngleDifference(expected, out);
+
+    cout << "Largest angle from slerp (radians): approximateSlerpTimes " << timesError << ", approximateSlerpPairs "
+        << pairsError << "\n";
+
+    reportApproximateSlerpAccuracy();
+}
+
+// Function to benchmark baking count evenly spaced samples of one pair with SlerpStepper and SlerpRecurrence
+// against calling slerp once per sample
+void runSlerpBakeBenchmark(size_t count) {
+    const Quaternion a = QuaternionCore::normalizeQuaternion(Quaternion(1, 2, 3, 4));
+    const Quaternion b = QuaternionCore::normalizeQuaternion(Quaternion(2, -1, 4, -1));
+
+    QuaternionArray expected(count), out(count);
+    Real stepSize = Real(1) / Real(max<size_t>(count, 2) - 1);
+
+    cout << "Slerp bake benchmark over " << count << " samples:\n";
+
+    benchmarkOperation("evenly spaced t (slerp vs SlerpStepper)", count,
+        [&] { for (size_t n = 0; n < count; n++) expected.set(n, slerp(a, b, n + 1 == count ? Real(1) : Real(n) * stepSize)); },
+        [&] { SlerpStepper stepper(a, b, count); for (size_t n = 0; n < count; n++) out.set(n, stepper.next()); });
+
+    Real stepperError = largestAngleDifference(expected, out);
+
+    benchmarkOperation("evenly spaced t (slerp vs SlerpRecurrence)", count,
+        [&] { for (size_t n = 0; n < count; n++) expected.set(n, slerp(a, b, n + 1 == count ? Real(1) : Real(n) * stepSize)); },
+        [&] { SlerpRecurrence recurrence(a, b, count); for (size_t n = 0; n < count; n++) out.set(n, recurrence.next()); });
+
+    Real recurrenceError = largestAngleDifference(expected, out);
+
+    cout << "Largest angle from slerp (radians): SlerpStepper " << stepperError << ", SlerpRecurrence " << recurrenceError << "\n";
+}
+
+// Function to check that both spline kinds pass through their keys, and to time sampling them in order with the
+// cursor against a binary search per sample
+void runSplineBenchmark(size_t count) {
+    mt19937_64 generator(11);
+    uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+    // Keys at uneven times, each a moderate turn from the one before
+    size_t keyCount = max<size_t>(count / 10, 4);
+    vector<Real> keyTimes(keyCount);
+    QuaternionArray keys(keyCount);
+    Quaternion key(1);
+
+    for (size_t n = 0; n < keyCount; n++) {
+        keyTimes[n] = n == 0 ? Real(0) : keyTimes[n - 1] + Real(1.5 + 0.5 * distribution(generator));
+        keys.set(n, key);
+        Quaternion turn(0, Real(0.5 * distribution(generator)), Real(0.5 * distribution(generator)), Real(0.5 * distribution(generator)));
+        key = QuaternionCore::normalizeQuaternion(key * exponentialPureQuaternion(turn));
+    }
+
+    vector<Real> times(count);
+    for (size_t n = 0; n < count; n++) {
+        times[n] = keyTimes.back() * Real(n) / Real(max<size_t>(count - 1, 1));
+    }
+
+    QuaternionArray expected(count), out(count), atKeys(keyCount);
+
+    cout << "Spline benchmark over " << count << " samples of " << keyCount << " keys:\n";
+
+    const SplineKind kinds[] = { SPLINE_SQUAD, SPLINE_CATMULL_ROM };
+    const char* names[] = { "SQUAD", "Catmull-Rom" };
+
+    for (int kind = 0; kind < 2; kind++) {
+        QuaternionSpline spline = prepareSpline(kinds[kind], keyTimes, keys);
+
+        evaluateSplineTimes(spline, keyTimes.data(), atKeys);
+        Real keyError = largestAngleDifference(spline.keys, atKeys);
+
+        benchmarkOperation(string(names[kind]) + " in order (binary search vs cursor)", count,
+            [&] {
+                for (size_t n = 0; n < count; n++) {
+                    size_t segment = findSplineSegment(spline, times[n]);
+                    Real u = (times[n] - spline.times[segment]) / (spline.times[segment + 1] - spline.times[segment]);
+                    expected.set(n, evaluateSplineSegment(spline, segment, min(max(u, Real(0)), Real(1))));
+                }
+            },
+            [&] { evaluateSplineTimes(spline, times.data(), out); });
+
+        cout << "Largest angle (radians): from the keys at the key times " << keyError << ", cursor from binary search "
+            << largestAngleDifference(expected, out) << "\n";
+    }
+
+    // Keys 126 degrees of rotation apart about changing axes, at uneven times. The intermediate points of these
+    // segments drift more than 90 degrees apart, so a hemisphere flip inside the evaluation would show up as a
+    // step of about pi between neighbouring samples; a smooth curve steps by about 126 degrees / samples.
+    const size_t wideKeyCount = 6;
+    const size_t samplesPerSegment = 1000;
+    vector<Real> wideTimes(wideKeyCount);
+    QuaternionArray wideKeys(wideKeyCount);
+    Quaternion wideKey(1);
+
+    for (size_t n = 0; n < wideKeyCount; n++) {
+        wideTimes[n] = n == 0 ? Real(0) : wideTimes[n - 1] + Real(n % 2 == 0 ? 1 : 3);
+        wideKeys.set(n, wideKey);
+        Real halfAngle = Real(0.35 * 3.14159265358979323846);
+        Quaternion axis = QuaternionCore::normalizeQuaternion(Quaternion(0, 1, Real(n % 3), Real(n % 2)));
+        wideKey = QuaternionCore::normalizeQuaternion(wideKey * (Quaternion(cos(halfAngle)) + axis * sin(halfAngle)));
+    }
+
+    for (int kind = 0; kind < 2; kind++) {
+        QuaternionSpline spline = prepareSpline(kinds[kind], wideTimes, wideKeys);
+        Real largestStep = 0;
+
+        for (size_t n = 0; n + 1 < wideKeyCount; n++) {
+            Quaternion previous = evaluateSplineSegment(spline, n, 0);
+
+            for (size_t m = 1; m <= samplesPerSegment; m++) {
+                Quaternion sample = evaluateSplineSegment(spline, n, Real(m) / Real(samplesPerSegment));
+                largestStep = max(largestStep, rotationAngleBetween(previous, sample));
+                previous = sample;
+            }
+        }
+
+        cout << names[kind] << " with keys 126 degrees apart: largest angle between neighbouring samples "
+            << largestStep << " radians over " << samplesPerSegment << " samples per segment\n";
+    }
+}
+
+// Function to parse a whole command-line argument as a positive integer, returning false if it is not one
+bool parsePositiveCount(const char* text, size_t& value) {
+    // strtoull accepts a leading sign and negates the value, so only digits are allowed
+    if (*text < '0' || *text > '9') {
+        return false;
+    }
+
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long parsed = strtoull(text, &end, 10);
+
+    if (errno != 0 || *end != '\0' || parsed == 0 || parsed > numeric_limits<size_t>::max()) {
+        return false;
+    }
+
+    value = static_cast<size_t>(parsed);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--benchmark") {
+        size_t count = 1000000;
+
+        if (argc > 2 && !parsePositiveCount(argv[2], count)) {
+            cerr << "Error: The benchmark count must be a positive integer." << endl;
+            return 1;
+        }
+
+        runSlerpBenchmark(count);
+        runApproximateSlerpBenchmark(count);
+        runSlerpBakeBenchmark(count);
+        runSplineBenchmark(count);
+        return 0;
+    }
+
+    // --approximate interpolates Slerp.txt with approximateSlerp instead of slerp
+    bool approximate = argc > 1 && string(argv[1]) == "--approximate";
+
     string filename = "Slerp.txt";
     ifstream inputFile(filename);
 
@@ -140,7 +978,8 @@ int main() {
 
     cout << "Interpolation Parameter t: " << t << endl;
 
-    Quaternion slerpResult = slerp(quaternionA, quaternionB, t);
+    Quaternion slerpResult = approximate ? approximateSlerp(QuaternionCore::normalizeQuaternion(quaternionA),
+        QuaternionCore::normalizeQuaternion(quaternionB), Real(t)) : slerp(quaternionA, quaternionB, t);
 
     cout << "\nSlerp Result: ";
     displayQuaternion(slerpResult);
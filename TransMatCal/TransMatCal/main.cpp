@@ -2,6 +2,8 @@
 #include <cmath>
 #include <vector>
 
+#include "../../Common/MatrixCore.h"
+
 using namespace std;
 
 // Function to display a matrix in column-major form
@@ -30,6 +32,19 @@ void displayMatrixRowMajor(const vector<vector<double>>& matrix) {
     }
 }
 
+// Function to multiply two matrices
+vector<vector<double>> multiplyMatrices(const vector<vector<double>>& matrix1, const vector<vector<double>>& matrix2) {
+    size_t cols1 = matrix1[0].size();
+    size_t rows2 = matrix2.size();
+
+    if (cols1 != rows2) {
+        cerr << "Error: Cannot multiply matrices. Invalid dimensions." << endl;
+        return {};
+    }
+
+    return MatrixCore::multiply(matrix1, matrix2);
+}
+
 // Function to perform scaling transformation
 vector<vector<double>> scale(const vector<vector<double>>& matrix, double scaleX, double scaleY, double scaleZ) {
     size_t rows = matrix.size();
@@ -236,37 +251,18 @@ vector<vector<double>> projectZ(const vector<vector<double>>& matrix) {
     return result;
 }
 
-// Function to multiply two matrices
-vector<vector<double>> multiplyMatrices(const vector<vector<double>>& matrix1, const vector<vector<double>>& matrix2) {
-    size_t rows1 = matrix1.size();
-    size_t cols1 = matrix1[0].size();
-    size_t rows2 = matrix2.size();
-    size_t cols2 = matrix2[0].size();
-
-    if (cols1 != rows2) {
-        cerr << "Error: Cannot multiply matrices. Invalid dimensions." << endl;
-        return {};
-    }
-
-    vector<vector<double>> result(rows1, vector<double>(cols2));
-
-    for (size_t i = 0; i < rows1; i++) {
-        for (size_t j = 0; j < cols2; j++) {
-            for (size_t k = 0; k < cols1; k++) {
-                result[i][j] += matrix1[i][k] * matrix2[k][j];
-            }
-        }
-    }
-
-    return result;
-}
-
 // Function to concatenate multiple transformations
-vector<vector<double>> concatenateTransformations(const vector<vector<double>>&... transformations) {
-    vector<vector<double>> result = transformations[sizeof...(transformations) - 1];
+template <typename... Transformations>
+vector<vector<double>> concatenateTransformations(const Transformations&... transformations) {
+    const vector<vector<double>>* list[] = { &transformations... };
+    size_t count = sizeof...(transformations);
+
+    vector<vector<double>> result = *list[count - 1];
 
     // Multiply the transformations in reverse order
-    ((result = multiplyMatrices(transformations[sizeof...(transformations) - 2 - sizeof...(transformations)], result)), ...);
+    for (size_t i = count - 1; i > 0; i--) {
+        result = multiplyMatrices(*list[i - 1], result);
+    }
 
     return result;
 }